@@ -0,0 +1,69 @@
+// ============================================================
+// Tempos de frame — histograma log-linear e percentis
+// 32 sub-buckets por oitava: o ponto médio do bucket fica a ≤1,6%
+// do valor, em memória constante. Não depende do Arduino: compila
+// nativo para os testes contra percentis exatos (firmware/test).
+// ============================================================
+#pragma once
+
+#include <stdint.h>
+
+static const int      FT_SUB_BITS = 5;
+static const int      FT_BUCKETS  = 512;    // cobre até 2^20 µs
+static const uint32_t FT_MAX_US   = (1u << 20) - 1;
+
+struct FrameTimeHist {
+  uint32_t n[FT_BUCKETS];
+  uint32_t count;
+  uint64_t sumUs;
+};
+
+struct FrameStats { uint16_t avg, low1, low01; };  // FPS
+
+static inline int frameTimeBucket(uint32_t us) {
+  // < 64 µs: exato; acima, oitava + 5 bits seguintes ao MSB
+  if (us > FT_MAX_US) us = FT_MAX_US;
+  if (us < (2u << FT_SUB_BITS)) return us;
+  int e = 31 - __builtin_clz(us);
+  int m = (us >> (e - FT_SUB_BITS)) & ((1 << FT_SUB_BITS) - 1);
+  return ((e - FT_SUB_BITS + 1) << FT_SUB_BITS) + m;
+}
+
+static inline uint32_t frameTimeBucketMid(int b) {
+  if (b < (2 << FT_SUB_BITS)) return b;
+  int e = (b >> FT_SUB_BITS) + FT_SUB_BITS - 1;
+  uint32_t lo = (uint32_t)((1 << FT_SUB_BITS) + (b & ((1 << FT_SUB_BITS) - 1))) << (e - FT_SUB_BITS);
+  return lo + ((1u << (e - FT_SUB_BITS)) >> 1);
+}
+
+static inline void frameTimeAdd(FrameTimeHist& h, uint32_t us) {
+  h.n[frameTimeBucket(us)]++;
+  h.count++;
+  h.sumUs += us;
+}
+
+static inline uint32_t frameTimePercentile(const FrameTimeHist& a, const FrameTimeHist& b, uint32_t perMille) {
+  // Tempo (µs) que só os perMille/1000 frames mais lentos passam
+  uint32_t total = a.count + b.count;
+  if (total == 0) return 0;
+  uint32_t want = (uint32_t)(((uint64_t)total * perMille + 999) / 1000);
+  if (want == 0) want = 1;
+  uint32_t seen = 0;
+  for (int i = FT_BUCKETS - 1; i >= 0; i--) {
+    seen += a.n[i] + b.n[i];
+    if (seen >= want) return frameTimeBucketMid(i);
+  }
+  return frameTimeBucketMid(0);
+}
+
+static inline FrameStats frameTimeStats(const FrameTimeHist& a, const FrameTimeHist& b) {
+  // FPS médio (frames / tempo total) e lows de 1% e 0,1%, arredondados
+  uint64_t sum = a.sumUs + b.sumUs;
+  uint32_t p99  = frameTimePercentile(a, b, 10);
+  uint32_t p999 = frameTimePercentile(a, b, 1);
+  FrameStats s;
+  s.avg   = sum ? (uint16_t)(((uint64_t)(a.count + b.count) * 1000000 + sum / 2) / sum) : 0;
+  s.low1  = p99  ? (uint16_t)((1000000 + p99 / 2) / p99)   : 0;
+  s.low01 = p999 ? (uint16_t)((1000000 + p999 / 2) / p999) : 0;
+  return s;
+}
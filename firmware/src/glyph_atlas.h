@@ -0,0 +1,79 @@
+// ============================================================
+// Atlas de glifos — texto grande em poucos fillRect
+// Cada glifo 6x8 da fonte GLCD vira faixas horizontais empilhadas
+// (retângulos); desenhar em escala N é um fillRect por retângulo em
+// vez de um por pixel aceso. Não depende do Arduino: compila nativo
+// para o teste e o benchmark de firmware/test.
+// ============================================================
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+static const char GLYPH_CHARS[]   = "0123456789:-";
+static const int  GLYPH_COUNT     = sizeof(GLYPH_CHARS) - 1;
+static const int  GLYPH_W         = 6;   // célula GLCD, com o espaçamento
+static const int  GLYPH_H         = 8;
+static const int  GLYPH_MAX_RECTS = 20;
+
+struct GlyphRect { uint8_t x, y, w, h; };  // em pixels da fonte (escala 1)
+
+struct Glyph {
+  uint8_t   n;      // 0 = glifo fora do atlas (usa drawString)
+  GlyphRect r[GLYPH_MAX_RECTS];
+};
+
+template <class Lit>
+static bool glyphBuild(Glyph& gl, Lit lit) {
+  // lit(x, y): pixel aceso na célula. Faixas de uma linha que repetem
+  // a de cima esticam o retângulo; false se não couber no atlas
+  gl.n = 0;
+  for (int y = 0; y < GLYPH_H; y++) {
+    for (int x = 0; x < GLYPH_W; ) {
+      if (!lit(x, y)) { x++; continue; }
+      int x0 = x;
+      while (x < GLYPH_W && lit(x, y)) x++;
+
+      int r = 0;
+      while (r < gl.n && !(gl.r[r].x == x0 && gl.r[r].w == x - x0 && gl.r[r].y + gl.r[r].h == y)) r++;
+      if (r < gl.n) {
+        gl.r[r].h++;
+      } else if (gl.n < GLYPH_MAX_RECTS) {
+        gl.r[gl.n++] = GlyphRect{ (uint8_t)x0, (uint8_t)y, (uint8_t)(x - x0), 1 };
+      } else {
+        gl.n = 0;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static inline const Glyph* glyphFind(const Glyph* atlas, char c) {
+  const char* p = strchr(GLYPH_CHARS, c);
+  if (!p || c == '\0') return nullptr;
+  const Glyph* g = &atlas[p - GLYPH_CHARS];
+  return g->n ? g : nullptr;
+}
+
+template <class Canvas>
+static bool glyphDraw(Canvas& c, const Glyph* atlas, const char* text,
+                      int cx, int cy, int size, uint16_t color) {
+  // Mesmo lugar do drawString com fonte GLCD, textSize = size e MC_DATUM.
+  // false (nada desenhado) se algum caractere estiver fora do atlas
+  size_t len = strlen(text);
+  for (size_t i = 0; i < len; i++) {
+    if (!glyphFind(atlas, text[i])) return false;
+  }
+
+  int x = cx - (int)len * GLYPH_W * size / 2;
+  int y = cy - (GLYPH_H * size - 1) / 2;
+  for (size_t i = 0; i < len; i++, x += GLYPH_W * size) {
+    const Glyph* g = glyphFind(atlas, text[i]);
+    for (int r = 0; r < g->n; r++) {
+      c.fillRect(x + g->r[r].x * size, y + g->r[r].y * size,
+                 g->r[r].w * size, g->r[r].h * size, color);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,113 @@
+// ============================================================
+// Histórico e gráficos rolando — anel por métrica e pixels por coluna
+// Cada gráfico guarda os próprios pixels (índices da paleta) num
+// buffer circular por coluna: amostra nova avança o início do
+// buffer e desenha só as colunas novas, sem mexer nas antigas.
+// Não depende do Arduino: compila nativo para o benchmark de
+// firmware/test.
+// ============================================================
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+static const int     HISTORY_LEN = 320;
+static const uint8_t GRAPH_BG    = 0;  // índice do fundo na paleta (PAL_BG)
+
+struct MetricHistory {
+  int16_t  v[HISTORY_LEN];
+  uint16_t head = 0;   // próxima posição de escrita
+  uint16_t count = 0;
+  uint32_t total = 0;  // amostras já recebidas (os gráficos rolam por ele)
+};
+
+static inline void historyPush(MetricHistory& h, int16_t v) {
+  h.v[h.head] = v;
+  h.head = (h.head + 1) % HISTORY_LEN;
+  if (h.count < HISTORY_LEN) h.count++;
+  h.total++;
+}
+
+static inline int16_t histAt(const MetricHistory& h, int age) {
+  // age 0 = amostra mais recente
+  return h.v[(h.head + HISTORY_LEN - 1 - age) % HISTORY_LEN];
+}
+
+enum GraphStyle : uint8_t { GRAPH_LINE, GRAPH_AREA };  // área: só a 1ª série
+
+struct GraphSeries { const MetricHistory* src; uint8_t line; };  // PAL_*
+
+struct Graph {
+  int16_t        x, y, w, h;
+  GraphStyle     style;
+  uint8_t        fill;     // PAL_* da área
+  uint8_t        ns;
+  GraphSeries    s[2];
+  int16_t        lo, hi;   // valores na base e no topo
+  const int16_t* steps;    // degraus de hi, terminados em 0; null = escala fixa
+  uint8_t*       px;       // w*h, linha a linha
+  uint16_t       start;    // coluna física da amostra mais antiga
+  uint32_t       seen;     // s[0].src->total já desenhado
+};
+
+static inline int graphY(const Graph& g, int v) {
+  v = std::min(std::max(v, (int)g.lo), (int)g.hi);
+  return g.h - 1 - (v - g.lo) * (g.h - 1) / (g.hi - g.lo);
+}
+
+static inline void graphColumn(Graph& g, int col, int age) {
+  // col lógica (0 = esquerda); liga cada ponto ao anterior na vertical
+  uint8_t* p = g.px + (g.start + col) % g.w;
+  for (int r = 0; r < g.h; r++) p[r * g.w] = GRAPH_BG;
+
+  for (int i = 0; i < g.ns; i++) {
+    const MetricHistory& h = *g.s[i].src;
+    if (age >= h.count) continue;
+    int y0 = graphY(g, histAt(h, age));
+    int y1 = (age + 1 < h.count) ? graphY(g, histAt(h, age + 1)) : y0;
+
+    if (i == 0 && g.style == GRAPH_AREA) {
+      for (int r = y0; r < g.h; r++) p[r * g.w] = g.fill;
+    }
+    for (int r = std::min(y0, y1); r <= std::max(y0, y1); r++) p[r * g.w] = g.s[i].line;
+  }
+}
+
+static inline void graphUpdate(Graph& g) {
+  const MetricHistory& h = *g.s[0].src;
+  uint32_t fresh = h.total - g.seen;
+  if (fresh == 0) return;
+  bool full = g.seen == 0 || fresh >= (uint32_t)g.w;
+
+  if (g.steps) {
+    // Escala só sobe, e aí os pontos antigos precisam ser refeitos
+    int n = full ? h.count : fresh;
+    int peak = 0;
+    for (int a = 0; a < n; a++) peak = std::max(peak, (int)histAt(h, a));
+    if (peak > g.hi) {
+      for (const int16_t* st = g.steps; *st; st++) {
+        g.hi = *st;
+        if (*st >= peak) break;
+      }
+      full = true;
+    }
+  }
+
+  if (full) {
+    g.start = 0;
+    for (int c = 0; c < g.w; c++) graphColumn(g, c, g.w - 1 - c);
+  } else {
+    // Rola: o início avança e só as colunas novas são desenhadas
+    g.start = (g.start + fresh) % g.w;
+    for (int a = fresh - 1; a >= 0; a--) graphColumn(g, g.w - 1 - a, a);
+  }
+  g.seen = h.total;
+}
+
+static inline void graphRow(const Graph& g, int row, uint8_t* line) {
+  // Linha row do gráfico em ordem lógica (desfaz o buffer circular)
+  const uint8_t* src = g.px + row * g.w;
+  memcpy(line, src + g.start, g.w - g.start);
+  memcpy(line + g.w - g.start, src, g.start);
+}
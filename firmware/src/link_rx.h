@@ -0,0 +1,112 @@
+// ============================================================
+// Recepção do link serial — linhas JSON e frames COBS
+// Separa o fluxo do Serial em linhas de texto e frames binários
+// delimitados por 0x00, sem heap. Não depende do Arduino: compila
+// nativo (g++) para os testes e benchmarks de firmware/test.
+// ============================================================
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+static const size_t RX_CHUNK_SIZE = 256;  // bloco lido do Serial por vez
+static const size_t RX_LINE_MAX   = 512;
+static const size_t FRAME_MAX     = 256;
+static const uint32_t RX_FRAME_GAP_MS = 50;  // silêncio que abandona um frame aberto
+
+// O que fazer com o byte que acabou de entrar
+enum RxEvent : uint8_t {
+  RX_NONE,      // consumido (dentro de frame ou de linha descartada)
+  RX_CHAR,      // byte da linha JSON: vai para o parser
+  RX_LINE_END,  // '\n' ou '\r' fechando a linha
+  RX_LINE_CUT,  // 0x00 abriu um frame: descarta a linha parcial
+  RX_FRAME,     // frame completo em frame[0..frameLen), ainda em COBS
+  RX_OVERFLOW,  // linha ou frame grande demais, descartado (volta ao texto)
+};
+
+struct LinkRx {
+  uint8_t  frame[FRAME_MAX];
+  size_t   frameLen = 0;
+  bool     inFrame = false;
+  uint16_t lineLen = 0;
+  bool     lineOverflow = false;  // resto da linha é ignorado até o '\n'
+  uint32_t lastRxAt = 0;          // ms do último bloco recebido
+};
+
+static inline RxEvent rxPush(LinkRx& rx, uint8_t c) {
+  if (c == 0x00) {
+    if (!rx.inFrame) {
+      // 0x00 de abertura: próximos bytes são COBS
+      rx.inFrame = true;
+      rx.frameLen = 0;
+      rx.lineLen = 0;
+      rx.lineOverflow = false;
+      return RX_LINE_CUT;
+    }
+    if (rx.frameLen == 0) return RX_NONE;  // 0x00 repetido
+    rx.inFrame = false;
+    return RX_FRAME;
+  }
+
+  if (rx.inFrame) {
+    if (rx.frameLen < FRAME_MAX) {
+      rx.frame[rx.frameLen++] = c;
+      return RX_NONE;
+    }
+    // Grande demais: sai do frame já, senão tudo até o próximo 0x00
+    // (inclusive o {"cmd":"hello"} de um host reiniciado) some aqui
+    rx.inFrame = false;
+    rx.frameLen = 0;
+    return RX_OVERFLOW;
+  }
+
+  if (c == '\n' || c == '\r') {
+    bool dropped = rx.lineOverflow;
+    rx.lineLen = 0;
+    rx.lineOverflow = false;
+    return dropped ? RX_NONE : RX_LINE_END;
+  }
+  if (rx.lineOverflow) return RX_NONE;
+  if (rx.lineLen >= RX_LINE_MAX) {
+    rx.lineOverflow = true;
+    return RX_OVERFLOW;
+  }
+  rx.lineLen++;
+  return RX_CHAR;
+}
+
+static inline bool rxGapExpired(LinkRx& rx, uint32_t now) {
+  // Chamado a cada bloco que chega. Um frame aberto há mais de
+  // RX_FRAME_GAP_MS é de um host que parou no meio do write: volta
+  // ao modo texto. true se havia bytes do frame (descartados).
+  bool expired = rx.inFrame && now - rx.lastRxAt > RX_FRAME_GAP_MS;
+  rx.lastRxAt = now;
+  if (!expired) return false;
+  rx.inFrame = false;
+  return rx.frameLen > 0;
+}
+
+// ── Frames binários ─────────────────────────────────────────
+static inline uint16_t crc16(const uint8_t* data, size_t len) {
+  // CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static inline size_t cobsDecode(uint8_t* buf, size_t len) {
+  // Decodifica in-place; retorna 0 se o frame estiver corrompido
+  size_t in = 0, out = 0;
+  while (in < len) {
+    uint8_t code = buf[in++];
+    if (code == 0 || in + code - 1 > len) return 0;
+    for (uint8_t i = 1; i < code; i++) buf[out++] = buf[in++];
+    if (code != 0xFF && in < len) buf[out++] = 0;
+  }
+  return out;
+}
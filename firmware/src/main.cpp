@@ -10,7 +10,21 @@
 #include <WiFi.h>
 #include <WiFiManager.h>
 #include <HTTPClient.h>
+#include <Preferences.h>
 #include <time.h>
+#include <sys/time.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <atomic>
+#include <algorithm>
+#include "link_rx.h"
+#include "telemetry.h"
+#include "seqlock.h"
+#include "frametime.h"
+#include "sample_batch.h"
+#include "glyph_atlas.h"
+#include "profiler.h"
+#include "graph.h"
 
 // ── NTP ─────────────────────────────────────────────────────
 static const char* NTP_SERVER   = "pool.ntp.org";
@@ -24,57 +38,100 @@ WiFiManager wm;
 // ── Protótipos ──────────────────────────────────────────────
 void setupWiFi();
 void syncNTP();
-void updateNtpTime();
-void fetchLocation();
-void fetchWeather();
+bool updateNtpTime();
+void netTask(void* arg);
+void fetchPolicyReset();
+bool bootCacheLoad();
+void bootCacheSave();
+void clockBecameValid();
+void ingestTask(void* arg);
+void pushTask(void* arg);
 void readSerial();
-void parseJson(const String &json);
+void parserFeed(char c);
 void drawBootScreen(const char* msg);
 void drawConfigScreen();
 void drawIdleScreen();
 void drawGamingScreen();
+void drawDebugOverlay();
+struct Widget;
+void renderScreen(Widget* ws, int n);
+bool serialLinkActive();
+void drawProfileOverlay();
+void drawScheduleOverlay();
+bool createFrameSprite(TFT_eSprite& frame);
+void buildPaletteTables();
+void buildGlyphAtlas();
+void drawBigText(const char* text, int cx, int cy, int size, uint16_t color);
+bool checkButton();
+void onButtonEdge();
+void scheduleFrameIn(unsigned long ms);
+void scheduleFrameTick(unsigned long period);
+void drainSamples();
 void drawHeart(int x, int y, int scale, int frame);
 void drawWeatherIcon(int ox, int oy, int s, int code);
+struct Graph;
+void drawGraph(Graph& g);
 uint16_t lightenColor(uint16_t color);
 
 // ── Display ─────────────────────────────────────────────────
 TFT_eSPI    tft = TFT_eSPI();
-TFT_eSprite spr = TFT_eSprite(&tft);
+
+// Dois buffers de frame: com FRAME_ASYNC_PUSH o render desenha em
+// um enquanto a task de push manda o outro para o display
+TFT_eSprite  frames[2] = { TFT_eSprite(&tft), TFT_eSprite(&tft) };
+TFT_eSprite* spr = &frames[0];  // buffer em que o render desenha
 
 static const int SCREEN_W = 320;
 static const int SCREEN_H = 170;
 
-// ── Paleta (RGB565) ─────────────────────────────────────────
-static const uint16_t COL_BG       = TFT_BLACK;
-static const uint16_t COL_CYAN     = 0x07FF;
-static const uint16_t COL_MAGENTA  = 0xF81F;
-static const uint16_t COL_GREEN    = 0x07E0;
-static const uint16_t COL_ORANGE   = 0xFDA0;
-static const uint16_t COL_YELLOW   = 0xFFE0;
-static const uint16_t COL_TEXT     = 0xFFFF;
-static const uint16_t COL_DIM      = 0x7BEF;
-static const uint16_t COL_RED      = 0xF800;
-static const uint16_t COL_SCANLINE = 0x0821;
-
-// Cores do coração
-static const uint16_t COL_HEART     = 0xF810;  // vermelho/rosa vibrante
-static const uint16_t COL_HEART_LT  = 0xFB2C;  // rosa claro (brilho)
-static const uint16_t COL_HEART_DK  = 0xC000;  // vermelho escuro (sombra)
+// ── Paleta ──────────────────────────────────────────────────
+// Todas as cores da UI (RGB565). Com FRAME_PALETTE o sprite do
+// frame é 4bpp e COL_* vira o índice da cor nesta tabela; o RGB565
+// só aparece no push para o display.
+// Compile com -DFRAME_PALETTE=0 para o sprite RGB565.
+#ifndef FRAME_PALETTE
+#define FRAME_PALETTE 1
+#endif
+#define UI_COLORS(X)                                                  \
+  X(BG,       TFT_BLACK)                                              \
+  X(CYAN,     0x07FF)                                                 \
+  X(MAGENTA,  0xF81F)                                                 \
+  X(GREEN,    0x07E0)                                                 \
+  X(GREEN_DK, 0x03E0)  /* bolinha de status apagada */                \
+  X(ORANGE,   0xFDA0)                                                 \
+  X(YELLOW,   0xFFE0)                                                 \
+  X(TEXT,     0xFFFF)                                                 \
+  X(DIM,      0x7BEF)                                                 \
+  X(RED,      0xF800)                                                 \
+  X(SCANLINE, 0x0821)                                                 \
+  X(HEART,    0xF810)  /* coração: vermelho/rosa vibrante */          \
+  X(HEART_LT, 0xFB2C)  /* rosa claro (brilho) */                      \
+  X(HEART_DK, 0xC000)  /* vermelho escuro (sombra) */
+
+#define X(name, rgb) PAL_##name,
+enum PaletteIndex : uint8_t { UI_COLORS(X) PAL_COUNT };
+#undef X
+static_assert(PAL_COUNT <= 16, "sprite 4bpp: no máximo 16 cores");
+
+#define X(name, rgb) rgb,
+static uint16_t PALETTE_RGB565[16] = { UI_COLORS(X) };
+#undef X
+
+// A mesma paleta na ordem de bytes do barramento (= a do sprite 16bpp)
+uint16_t paletteWire[16];
+
+#if FRAME_PALETTE
+#define X(name, rgb) static const uint16_t COL_##name = PAL_##name;
+static const int FRAME_BPP = 4;
+#else
+#define X(name, rgb) static const uint16_t COL_##name = rgb;
+static const int FRAME_BPP = 16;
+#endif
+UI_COLORS(X)
+#undef X
 
 // ── Dados recebidos ─────────────────────────────────────────
-struct HWData {
-  int cpu      = 0;
-  int gpu      = 0;
-  int ram      = 0;
-  int cpu_temp = 0;
-  int gpu_temp = 0;
-  int fps      = 0;
-  int cpu_clk  = 0;
-  int gpu_clk  = 0;
-  char hora[6]  = "--:--";
-  char data[12] = "";
-};
-
+// HWData, FIELDS e o parser ficam em telemetry.h
 HWData hw;
 
 // ── Estado da conexão serial ────────────────────────────────
@@ -83,7 +140,339 @@ static const unsigned long SERIAL_TIMEOUT_MS = 5000;
 bool hasSerialData = false;
 
 // ── Serial buffer ───────────────────────────────────────────
-String serialBuffer = "";
+// Bloco de leitura fixo (sem heap): o Serial é lido em rajadas e
+// linkRx (link_rx.h) separa linhas JSON de frames COBS.
+char   rxBuf[RX_CHUNK_SIZE];
+LinkRx linkRx;
+
+// ── Parser de telemetria ────────────────────────────────────
+// tp (telemetry.h) grava os campos em hwStage; a linha só é
+// aplicada em hw quando chega o '\n' e o objeto fechou sem erro.
+TelemetryParser tp;
+HWData hwStage;
+StageMeta stage;
+
+// ── Saúde do link serial ────────────────────────────────────
+// Escritos só pela task de ingestão; overlay e comando "stats"
+// apenas leem (palavras de 32 bits alinhadas).
+struct LinkStats {
+  volatile uint32_t rxBytes;
+  volatile uint32_t messages;      // mensagens aplicadas
+  volatile uint32_t jsonErrors;    // linha JSON malformada
+  volatile uint32_t frameErrors;   // COBS, versão ou tamanho inválido
+  volatile uint32_t crcErrors;
+  volatile uint32_t overflows;     // linha ou frame grande demais
+  volatile uint32_t seqGaps;       // lacunas de sequência detectadas
+  volatile uint32_t deltaDrops;    // deltas descartados esperando keyframe
+  volatile uint32_t keyframeReqs;
+  volatile uint32_t sampleDrops;   // fila de histórico cheia
+  volatile uint32_t bytesPerSec;
+  volatile uint32_t msgsPerSec;
+  volatile uint32_t lastGapMs;     // intervalo entre as duas últimas mensagens
+};
+
+LinkStats linkStats = {};
+static const unsigned long LINK_RATE_WINDOW = 1000;
+unsigned long lastMessageAt = 0;
+unsigned long rateWindowStart = 0;
+uint32_t rateBytesMark = 0;
+uint32_t rateMsgsMark = 0;
+
+// ── Delta / keyframes ───────────────────────────────────────
+// Deltas só valem em sequência; numa lacuna pede keyframe ao host.
+uint8_t lastSeq = 0;
+bool    seqValid = false;
+unsigned long lastKeyframeReq = 0;
+static const unsigned long KEYFRAME_REQ_INTERVAL = 250;
+
+// ── Relógio do host ─────────────────────────────────────────
+// Estilo NTP: o ESP32 manda {"evt":"ping","t0":millis} e o host
+// responde com o próprio relógio em t1. De cada janela de pings
+// fica o de menor RTT (menor assimetria); o drift sai da variação
+// do offset ao longo de pelo menos CLOCK_DRIFT_SPAN.
+static const unsigned long CLOCK_PING_FAST   = 200;    // até o primeiro ajuste
+static const unsigned long CLOCK_PING_PERIOD = 2000;
+static const uint8_t       CLOCK_WINDOW      = 8;      // pings por ajuste
+static const uint32_t      CLOCK_RTT_MAX     = 500;
+static const uint32_t      CLOCK_DRIFT_SPAN  = 60000;
+static const float         CLOCK_DRIFT_MAX   = 0.001f; // acima disso o host reiniciou
+
+struct HostClock {
+  bool     synced = false;
+  uint32_t offset = 0;     // host − ESP32 (ms, módulo 2^32) em ref
+  uint32_t ref = 0;        // millis() do último ajuste
+  uint32_t rtt = 0;        // RTT do ping usado no último ajuste
+  float    drift = 0;      // ms de offset por ms do ESP32
+  bool     driftValid = false;
+  uint32_t anchorOffset = 0, anchorMid = 0;
+  uint8_t  pings = 0;      // janela em andamento
+  uint32_t bestRtt = UINT32_MAX, bestOffset = 0, bestMid = 0;
+  unsigned long lastPing = 0;
+};
+
+HostClock hostClock;
+
+// ── Latência ponta a ponta ──────────────────────────────────
+// Últimas LAT_SAMPLES medições (ms) desde a amostragem no host.
+// Cada anel tem um único escritor; os percentis são calculados
+// sobre uma cópia, então uma leitura concorrente só vê uma
+// amostra a mais ou a menos.
+static const int LAT_SAMPLES = 128;
+
+struct LatencyRing {
+  uint16_t v[LAT_SAMPLES];
+  volatile uint16_t head;
+  volatile uint16_t count;
+};
+
+struct LatencyPct { uint16_t p50, p95, p99; };
+
+LatencyRing latParse = {};  // amostra no host → parse (ingestão)
+LatencyRing latPush  = {};  // amostra no host → fim do pushSprite
+
+void latencyAdd(LatencyRing& r, uint32_t sampledAt);
+LatencyPct latencyPercentiles(const LatencyRing& r);
+
+// ── Profiler por estágio ────────────────────────────────────
+// Escopos em volta dos estágios do render, do push e da leitura
+// serial, contando ciclos do core (cada estágio roda numa task fixa
+// num core). Os últimos PROF_SAMPLES valores de cada estágio dão
+// min/méd/p99 (profiler.h) no overlay (segunda página) e no comando
+// "prof".
+#ifndef PROFILER
+#define PROFILER 1
+#endif
+
+// Estágios até FENCE fecham uma amostra por frame (presentFrame);
+// PUSH e RX fecham uma por chamada
+#define PROF_STAGES(X)                                                \
+  X(FRAME,   "frame")    /* render inteiro, sem hash e push */        \
+  X(CLEAR,   "clear")    /* fillSprite */                             \
+  X(TEXT,    "text")     /* resto do render: texto, linhas */         \
+  X(GLYPH,   "glyph")    /* drawBigText */                            \
+  X(ART,     "art")      /* coração e ícones do clima */              \
+  X(GRAPH,   "graph")    /* gráficos: colunas novas + cópia */        \
+  X(OVERLAY, "overlay")                                               \
+  X(HASH,    "hash")     /* hash dos tiles + retângulos */            \
+  X(FENCE,   "fence")    /* espera pelo push anterior */              \
+  X(PUSH,    "push")                                                  \
+  X(RX,      "rx")       /* readSerial com bytes, parse incluso */
+
+#define X(name, label) PROF_##name,
+enum ProfStage : uint8_t { PROF_STAGES(X) PROF_COUNT };
+#undef X
+
+#define X(name, label) label,
+static const char* const PROF_NAMES[PROF_COUNT] = { PROF_STAGES(X) };
+#undef X
+
+ProfRing prof[PROF_COUNT] = {};
+uint32_t frameStartTick = 0;  // runRender(); 0 = frame sem agendamento (boot)
+
+void profCommit(ProfStage s);
+ProfStat profStat(ProfStage s);
+
+#if PROFILER
+#define PROF_SCOPE(s) ProfScope profScope_(prof[s], false)  // soma no frame
+#define PROF_EVENT(s) ProfScope profScope_(prof[s], true)   // uma amostra por escopo
+#else
+#define PROF_SCOPE(s) ((void)0)
+#define PROF_EVENT(s) ((void)0)
+#endif
+
+// ── Protocolo binário ───────────────────────────────────────
+// Frame: 0x00 | COBS(versão, tipo, seq, ts, máscara, campos LE, CRC16 LE) | 0x00
+// O 0x00 inicial distingue o frame de uma linha JSON ('{').
+static const uint8_t PROTO_VERSION  = 3;
+static const uint8_t FRAME_KEYFRAME = 0x01;
+static const uint8_t FRAME_DELTA    = 0x02;
+static const uint8_t FRAME_FRAMETIMES = 0x03;  // n (u8) | n x tempo de frame (u16, 10 µs)
+static const int     MAX_MESSAGE_HZ = 60;  // anunciado no handshake
+static const int     FT_BATCH_MAX   = 96;  // tempos de frame por frame (anunciado)
+
+static const char* const MONTH_ABBR[12] = {
+  "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+  "Jul", "Aug", "Sep", "Oct", "Nov", "Dec",
+};
+
+// ── Ingestão (task dedicada) ────────────────────────────────
+// Serial + parser rodam numa task própria no core 0; o loop de
+// render (core 1) só lê snapshots publicados via seqlock.
+static const BaseType_t INGEST_CORE     = 0;
+static const UBaseType_t INGEST_PRIORITY = 3;
+static const uint32_t   INGEST_STACK    = 4096;
+static const TickType_t INGEST_POLL     = pdMS_TO_TICKS(1);
+
+HWData hwIngest;  // último estado completo do lado da ingestão
+
+Seqlock<HWData> telemetry;  // seqlock.h
+uint32_t telemetrySeen = 0;  // última versão lida pelo render
+
+bool telemetryRead(HWData& out);
+
+// ── Histórico por métrica ───────────────────────────────────
+// Amostras (inclusive as sub-segundo dos lotes de sample_batch.h)
+// vão da ingestão para o render por uma fila SPSC sem lock; o
+// render guarda as últimas HISTORY_LEN de cada métrica (graph.h).
+static const size_t SAMPLE_QUEUE_LEN = 64;   // potência de 2
+
+HistorySample sampleQueue[SAMPLE_QUEUE_LEN];
+std::atomic<uint32_t> sampleHead{0};  // escrito pela ingestão
+std::atomic<uint32_t> sampleTail{0};  // escrito pelo render
+MetricHistory history[HIST_METRICS];
+
+// ── Tempos de frame (RTSS) ──────────────────────────────────
+// O host manda o tempo de cada frame do jogo; a ingestão só
+// enfileira (SPSC) e o loop alimenta o histograma de frametime.h.
+// Duas janelas de FT_WINDOW_MS dão FPS médio e as lows de 1% e
+// 0,1% (percentis 99 e 99,9 do tempo de frame) em memória constante.
+static const size_t        FT_QUEUE_LEN = 256;    // potência de 2
+static const unsigned long FT_WINDOW_MS = 10000;  // lows sobre os últimos 10–20 s
+static const unsigned long FT_LIVE_MS   = 2000;   // sem tempos novos: volta ao FPS
+
+uint16_t ftQueue[FT_QUEUE_LEN];            // 10 µs, da ingestão para o loop
+std::atomic<uint32_t> ftHead{0};           // escrito pela ingestão
+std::atomic<uint32_t> ftTail{0};           // escrito pelo render
+FrameTimeHist ftHist[2];                   // janela atual e a anterior
+uint8_t       ftCur = 0;
+unsigned long ftWindowAt = 0;
+unsigned long ftLastAt = 0;                // millis() do último tempo recebido
+FrameStats    frameStats = {};
+MetricHistory ftHistory;                   // tempos recentes (0,1 ms), gráfico
+
+bool drainFrameTimes();
+
+// ── Gráficos de histórico ───────────────────────────────────
+// Pixels próprios em buffer circular por coluna (graph.h): amostra
+// nova desenha só as colunas novas. Por frame resta copiar o
+// retângulo para o sprite.
+static const int GRAPH_W      = HISTORY_LEN;  // 1 px por amostra
+static const int FPS_GRAPH_Y  = 60;           // atrás do FPS gigante
+static const int FPS_GRAPH_H  = 56;
+static const int TEMP_GRAPH_Y = 120;          // acima das temps
+static const int TEMP_GRAPH_H = 14;
+static const int LOAD_GRAPH_Y = 124;          // acima do rodapé
+static const int LOAD_GRAPH_H = 24;
+static_assert(GRAPH_W <= SCREEN_W && GRAPH_W % 2 == 0, "x e w pares (sprite 4bpp)");
+
+// Degraus do topo da escala (só cresce): FPS e tempo de frame (0,1 ms)
+static const int16_t FPS_SCALE_STEPS[] = { 60, 120, 165, 240, 360, 500, 1000, 0 };
+static const int16_t FT_SCALE_STEPS[]  = { 167, 333, 500, 1000, 2500, 5000, 0 };
+
+static_assert(PAL_BG == GRAPH_BG, "fundo dos gráficos");
+
+// FPS e tempos de frame ocupam o mesmo lugar e dividem os pixels
+uint8_t bigGraphPx[GRAPH_W * FPS_GRAPH_H];
+uint8_t tempGraphPx[GRAPH_W * TEMP_GRAPH_H];
+uint8_t loadGraphPx[GRAPH_W * LOAD_GRAPH_H];
+
+Graph fpsGraph  = { 0, FPS_GRAPH_Y, GRAPH_W, FPS_GRAPH_H, GRAPH_AREA, PAL_GREEN_DK, 1,
+                    {{&history[FID_FPS], PAL_GREEN}}, 0, 60, FPS_SCALE_STEPS,
+                    bigGraphPx, 0, 0 };
+Graph ftGraph   = { 0, FPS_GRAPH_Y, GRAPH_W, FPS_GRAPH_H, GRAPH_AREA, PAL_GREEN_DK, 1,
+                    {{&ftHistory, PAL_GREEN}}, 0, 167, FT_SCALE_STEPS,
+                    bigGraphPx, 0, 0 };
+Graph tempGraph = { 0, TEMP_GRAPH_Y, GRAPH_W, TEMP_GRAPH_H, GRAPH_LINE, PAL_BG, 2,
+                    {{&history[FID_CPU_TEMP], PAL_CYAN}, {&history[FID_GPU_TEMP], PAL_MAGENTA}},
+                    30, 100, nullptr, tempGraphPx, 0, 0 };
+Graph loadGraph = { 0, LOAD_GRAPH_Y, GRAPH_W, LOAD_GRAPH_H, GRAPH_LINE, PAL_BG, 2,
+                    {{&history[FID_CPU], PAL_CYAN}, {&history[FID_GPU], PAL_MAGENTA}},
+                    0, 100, nullptr, loadGraphPx, 0, 0 };
+
+// ── Retângulos sujos ────────────────────────────────────────
+// Só vão para o display os tiles cujo hash mudou desde o último
+// push. Na UI retida só os tiles danificados são hasheados.
+static const int TILE_W  = 32;
+static const int TILE_H  = 10;
+static const int TILES_X = SCREEN_W / TILE_W;
+static const int TILES_Y = (SCREEN_H + TILE_H - 1) / TILE_H;
+static const int FULL_PUSH_TILES = TILES_X * TILES_Y * 3 / 4;  // acima: frame inteiro
+static_assert(SCREEN_W % TILE_W == 0, "TILE_W precisa dividir SCREEN_W");
+
+struct DirtyRect { uint8_t x0, x1, y0, y1; };  // em tiles, fim exclusivo
+
+uint32_t tileHash[TILES_Y][TILES_X];
+bool     fullRedraw = true;    // próximo push manda o frame inteiro
+uint16_t pushedTiles = 0;      // último frame (overlay)
+uint8_t  pushedRects = 0;
+
+typedef bool TileMask[TILES_Y][TILES_X];
+void presentFrame(const TileMask* damage = nullptr);  // nullptr: frame inteiro
+
+// ── UI retida ───────────────────────────────────────────────
+// Cada tela é uma lista de widgets em ordem de desenho. A cada
+// frame bind() lê o valor ligado (HWData, relógio, fase da
+// animação) e devolve uma chave; só os widgets cuja chave mudou
+// danificam seus tiles. Os tiles danificados são limpos e todo
+// widget que os cruza é redesenhado com clip neles; o resto do
+// sprite fica como estava.
+typedef uint32_t (*WidgetBind)(Widget& w);
+typedef void     (*WidgetPaint)(const Widget& w);
+
+struct LabelStyle {
+  int16_t ax, ay;   // âncora
+  uint8_t size;
+  uint8_t datum;    // ignorado em big (sempre MC)
+  bool    big;      // atlas de glifos (drawBigText)
+};
+
+struct Widget {
+  int16_t     x, y, w, h;     // limites: dano, limpeza e clip
+  WidgetBind  bind;
+  WidgetPaint paint;
+  const LabelStyle* label;    // rótulos; nullptr nos demais
+  char        text[24];       // rótulo em cache ("" = oculto)
+  uint16_t    color;
+  int32_t     value;          // estado ligado dos widgets sem texto
+  uint32_t    key;            // conteúdo desenhado no último frame
+};
+
+struct PixelRect { int16_t x0, y0, x1, y1; };  // fim exclusivo
+
+const Widget* uiScreen = nullptr;  // tela retida no sprite; nullptr = imediata
+TileMask      uiPrevDamage;        // dano do frame anterior (o outro buffer)
+PixelRect     uiClip = { 0, 0, SCREEN_W, SCREEN_H };  // clip do paint atual
+
+// ── Push assíncrono ─────────────────────────────────────────
+// O TFT_eSPI não tem DMA no barramento paralelo 8-bit: o push é
+// feito pela CPU. Com FRAME_ASYNC_PUSH ele vai para uma task no
+// core 0 enquanto o core 1 desenha o próximo frame no outro buffer.
+// Compile com -DFRAME_ASYNC_PUSH=0 para o push síncrono.
+#ifndef FRAME_ASYNC_PUSH
+#define FRAME_ASYNC_PUSH 1
+#endif
+static const BaseType_t  PUSH_CORE     = 0;
+static const UBaseType_t PUSH_PRIORITY = 2;  // abaixo da ingestão
+static const uint32_t    PUSH_STACK    = 4096;
+
+struct FramePush {
+  TFT_eSprite* src;
+  bool         full;       // frame inteiro num bloco só
+  uint8_t      n;
+  DirtyRect    rects[TILES_X * TILES_Y / 2 + 1];
+  uint32_t     sampledAt;  // carimbo do snapshot desenhado (latência)
+};
+
+FramePush framePush;                // job em andamento, lido pela task de push
+SemaphoreHandle_t pushStart = nullptr;
+SemaphoreHandle_t pushDone  = nullptr;
+bool asyncPush = false;             // FRAME_ASYNC_PUSH e o segundo buffer coube
+volatile uint32_t pushUs  = 0;      // duração do último push
+volatile uint32_t fenceUs = 0;      // render esperando o push anterior
+uint32_t frameStartUs = 0;          // início do frame (runRender)
+uint32_t renderUs = 0;              // desenho do último frame, sem o push
+
+// ── Atlas de glifos (FPS gigante e relógio) ─────────────────
+// A fonte GLCD em tamanho 4/7 vira um fillRect por pixel da matriz
+// 5x7. No boot cada glifo usado é lido uma vez e reduzido a poucos
+// retângulos (glyph_atlas.h); desenhar um número grande passa a ser
+// um punhado de fillRect em qualquer escala. Compile com
+// -DGLYPH_ATLAS=0 para comparar com o drawString; o bench_glyph de
+// firmware/test mede os dois caminhos.
+#ifndef GLYPH_ATLAS
+#define GLYPH_ATLAS 1
+#endif
+Glyph glyphAtlas[GLYPH_COUNT];
 
 // ── Scanline ────────────────────────────────────────────────
 int scanlineOffset = 0;
@@ -93,17 +482,96 @@ bool inGamingMode = false;
 unsigned long lastFpsTime = 0;
 static const unsigned long GAMING_COOLDOWN_MS = 3000;
 
-// ── Animação idle ───────────────────────────────────────────
-unsigned long idleAnimTimer = 0;
-int idleFrame = 0;
+// ── Overlay de debug (botão direito, GPIO 14) ───────────────
+static const int BTN_PIN = 14;
+static const unsigned long BTN_DEBOUNCE_MS = 50;
+// Cada toque avança a página: desligado → link → profiler → agendador
+enum DebugPage : uint8_t { DEBUG_OFF, DEBUG_LINK, DEBUG_PROF, DEBUG_SCHED, DEBUG_PAGES };
+uint8_t debugPage = DEBUG_OFF;
+int  btnLevel = HIGH;            // nível aceito depois do debounce
+unsigned long btnChangedAt = 0;
+
+// ── Agendador cooperativo ───────────────────────────────────
+// O loop() é um agendador de prazos. Cada tarefa tem um prazo,
+// período (0 = só quando alguém agenda), prioridade (menor roda
+// antes), intervalo mínimo entre execuções e orçamento. Cada
+// passada roda a tarefa vencida de maior prioridade (empate: o
+// prazo mais antigo); sem nada vencido dorme numa notificação
+// (ingestão, botão) com timeout até o próximo prazo. O atraso de
+// cada execução em relação ao prazo (jitter) e o tempo contra o
+// orçamento ficam por tarefa: overlay (3ª página) e "sched".
+#define SCHED_TASKS(X)                                                     \
+  /*  nome     rótulo     prio  período         gap           orçam. µs */ \
+  X(INGEST,  "ingest",   0,    0,              0,            1000)         \
+  X(RENDER,  "render",   1,    0,              FRAME_MIN_MS, 20000)        \
+  X(NET,     "net",      2,    0,              0,            1000)         \
+  X(LINK,    "link",     3,    LINK_PERIOD_MS, 0,            2000)         \
+  X(TIME,    "time",     4,    TIME_PERIOD_MS, 0,            1000)         \
+  X(WEATHER, "weather",  5,    0,              0,            1000)
+
+// Render: só desenha quando algo visível mudou (snapshot novo,
+// minuto do relógio, overlay, troca de tela) ou quando vence o
+// próximo passo de uma animação. As animações derivam a fase de
+// millis(), então o redraw cai exatamente na borda do período.
+static const unsigned long IDLE_BEAT_MS       = 600;   // batida do coração
+static const unsigned long GAMING_PULSE_MS    = 500;   // bolinha de status
+static const unsigned long SCANLINE_STEP_MS   = 50;    // scanline > 80°C
+static const unsigned long CONFIG_DOT_MS      = 300;   // tela de config
+static const unsigned long OVERLAY_REFRESH_MS = 250;
+static const unsigned long FRAME_MIN_MS       = 16;    // teto de ~60 fps
+static const unsigned long LOOP_MAX_SLEEP_MS  = 1000;  // teto do sono sem prazo
+static const unsigned long PORTAL_POLL_MS     = 50;    // wm.process() do portal
+static const unsigned long LINK_PERIOD_MS     = 1000;  // estado do WiFi
+static const unsigned long TIME_PERIOD_MS     = 60000; // relógio NTP (e a virada do minuto)
+
+#define X(name, label, prio, period, gap, budget) SCHED_##name,
+enum SchedId : uint8_t { SCHED_TASKS(X) SCHED_COUNT };
+#undef X
+
+struct SchedDef {
+  const char*   name;
+  uint8_t       priority;
+  unsigned long period;
+  unsigned long gap;       // intervalo mínimo entre inícios (ms)
+  uint32_t      budgetUs;
+};
+
+#define X(name, label, prio, period, gap, budget) { label, prio, period, gap, budget },
+static const SchedDef SCHED_DEFS[SCHED_COUNT] = { SCHED_TASKS(X) };
+#undef X
+
+struct SchedTask {
+  unsigned long due;
+  bool          armed;
+  unsigned long lastStart;
+  uint32_t      runs;
+  uint32_t      overruns;  // execuções acima do orçamento
+  uint32_t      lastUs, maxUs;
+  LatencyRing   late;      // atraso do início em relação ao prazo (ms)
+};
+
+SchedTask sched[SCHED_COUNT] = {};
+
+void schedAt(SchedId id, unsigned long at);
+void schedIn(SchedId id, unsigned long ms);
+void schedKick();
+int  schedNext();
+void schedRun(SchedId id);
+void schedSleep(unsigned long maxSleep);
+
+TaskHandle_t  renderTaskHandle = nullptr;  // loopTask, acordado pela ingestão
+bool          frameDirty = true;           // vira prazo imediato do render
 
 // ── NTP time ────────────────────────────────────────────────
+// configTime() só liga o SNTP do ESP32; runTime() confere a hora
+// sem bloquear até ela chegar
+bool ntpStarted = false;
 bool ntpSynced = false;
-unsigned long lastNtpUpdate = 0;
-static const unsigned long NTP_UPDATE_INTERVAL = 60000;  // atualiza a cada 60s
+static const unsigned long NTP_POLL_MS = 500;
 
 // ── WiFi ────────────────────────────────────────────────────
 bool wifiConnected = false;
+bool wifiConnecting = false;  // autoConnect() do boot em andamento
 
 // ── Clima ────────────────────────────────────────────────────
 float weatherLat = 0, weatherLon = 0;
@@ -111,7 +579,131 @@ int   weatherTemp = 0;
 int   weatherCode = -1;
 bool  weatherValid = false;
 unsigned long lastWeatherUpdate = 0;
+#ifdef NET_TEST_HOST
+static const unsigned long WEATHER_INTERVAL = 30000;   // servidor de teste: 30 s
+#else
 static const unsigned long WEATHER_INTERVAL = 900000;  // 15 min
+#endif
+// Clima velho continua na tela (com a idade) até WEATHER_MAX_AGE;
+// passado WEATHER_STALE_MS a idade fica em destaque
+static const unsigned long WEATHER_STALE_MS  = 2 * WEATHER_INTERVAL;
+static const unsigned long WEATHER_MAX_AGE   = 6 * 3600000UL;  // 6 h
+
+// ── Rede (task dedicada) ────────────────────────────────────
+// Todo HTTP roda numa task própria no core 0. O loop só enfileira
+// pedidos; os resultados voltam por outra fila e as callbacks rodam
+// no loop (tarefa "net" do agendador), então só ele mexe no estado
+// do clima. Render e ingestão nunca esperam um GET.
+static const BaseType_t  NET_CORE        = 0;
+static const UBaseType_t NET_PRIORITY    = 1;     // abaixo do push e da ingestão
+static const uint32_t    NET_STACK       = 8192;  // TLS do open-meteo
+static const int         NET_QUEUE_LEN   = 4;
+static const uint16_t    HTTP_TIMEOUT_MS = 5000;
+static const int         NET_ERR_PARSE   = -100;  // abaixo dos erros do HTTPClient
+
+// As respostas são lidas direto do socket por um filtro do
+// ArduinoJson que só guarda os campos usados: sem String com o
+// corpo inteiro na heap nem DOM do resto. Compile com
+// -DHTTP_STREAM_JSON=0 para comparar (getString + DOM inteiro);
+// a heap de cada busca sai no "stats" (net_heap, net_body).
+#ifndef HTTP_STREAM_JSON
+#define HTTP_STREAM_JSON 1
+#endif
+
+// Endpoints. Para testar a task de rede contra um servidor local que
+// atrasa ou derruba respostas (host/net_standin.py), compile com
+// -DNET_TEST_HOST=\"192.168.0.10:8080\" (env "net-test" do
+// platformio.ini): as duas buscas vão em HTTP para esse host, nos
+// mesmos caminhos.
+#ifdef NET_TEST_HOST
+static const char* LOCATION_URL = "http://" NET_TEST_HOST "/json/?fields=lat,lon";
+static const char* WEATHER_URL  = "http://" NET_TEST_HOST "/v1/forecast";
+#else
+static const char* LOCATION_URL = "http://ip-api.com/json/?fields=lat,lon";
+static const char* WEATHER_URL  = "https://api.open-meteo.com/v1/forecast";
+#endif
+
+static const size_t LOCATION_DOC = 64;
+static const size_t WEATHER_DOC  = HTTP_STREAM_JSON ? 128 : 512;
+
+enum NetJob : uint8_t { NET_LOCATION, NET_WEATHER, NET_JOBS };
+
+struct NetResult;
+typedef void (*NetCallback)(const NetResult& r);
+
+struct NetRequest {
+  NetJob      job;
+  float       lat, lon;   // NET_WEATHER
+  NetCallback done;
+};
+
+struct NetResult {
+  NetJob      job;
+  NetCallback done;
+  int         status;     // código HTTP; < 0 erro de conexão ou parse
+  uint32_t    ms;         // duração do pedido
+  uint32_t    heapDrop;   // queda da heap livre global na busca (HeapWatch)
+  uint32_t    bodyHeap;   // resposta guardada na heap pelo parse
+  float       lat, lon;   // NET_LOCATION
+  int         temp, code; // NET_WEATHER
+};
+
+QueueHandle_t netRequests = nullptr;
+QueueHandle_t netResults  = nullptr;
+bool netPending[NET_JOBS] = {};  // na fila ou em andamento (só o loop mexe)
+
+bool netRequest(NetJob job, NetCallback done, float lat = 0, float lon = 0);
+
+// ── Política de busca (por endpoint) ────────────────────────
+// Falha = backoff exponencial com jitter (metade fixa, metade
+// aleatória), para não martelar o endpoint nem sincronizar com
+// outros clientes. Depois de FETCH_FAILURE_BUDGET falhas seguidas
+// o endpoint fica em FETCH_BACKOFF_MAX até o WiFi reconectar.
+static const unsigned long FETCH_BACKOFF_BASE   = 30000;    // 30 s
+static const unsigned long FETCH_BACKOFF_MAX    = 1800000;  // 30 min
+static const uint8_t       FETCH_FAILURE_BUDGET = 6;
+
+struct FetchPolicy {
+  uint8_t       failures;   // seguidas
+  int           lastStatus;
+  uint32_t      heapDrop;   // maior queda de heap numa busca (global)
+  uint32_t      bodyHeap;   // maior resposta guardada na heap
+  unsigned long lastOkAt;   // 0 = nunca
+  unsigned long nextAt;     // não tenta antes disso
+};
+
+FetchPolicy fetchPolicy[NET_JOBS] = {};
+
+// ── Cache de boot (NVS + RTC) ───────────────────────────────
+// Localização e último clima (com o epoch de cada um) ficam na NVS;
+// o boot pinta a tela idle com eles antes do WiFi e só refaz o que
+// estiver velho, em segundo plano. A hora fica na RTC (sobrevive a
+// reset por software/watchdog, não a falta de energia).
+static const char*    BOOT_CACHE_NS      = "hwmon";
+static const char*    BOOT_CACHE_KEY     = "boot";
+static const uint16_t BOOT_CACHE_VERSION = 1;
+static const uint32_t LOCATION_MAX_AGE_S = 7 * 86400;  // ip-api de novo depois disso
+static const uint32_t RTC_CLOCK_MAGIC    = 0x48574d43;  // "HWMC"
+static const uint32_t EPOCH_VALID_MIN    = 1700000000;  // nov/2023: relógio acertado
+
+struct BootCache {
+  uint16_t version;
+  float    lat, lon;
+  uint32_t locAt;   // epoch da localização (0 = desconhecido)
+  int16_t  temp;
+  int16_t  code;    // -1 = sem clima
+  uint32_t wxAt;    // epoch do clima (0 = desconhecido)
+};
+
+struct RtcClock {
+  uint32_t magic;
+  uint32_t epoch;   // última hora conhecida
+};
+
+BootCache bootCache = { BOOT_CACHE_VERSION, 0, 0, 0, 0, -1, 0 };
+RTC_NOINIT_ATTR RtcClock rtcClock;
+bool locationStale  = false;  // cache da localização passou de LOCATION_MAX_AGE_S
+bool weatherAgeKnown = true;  // clima do cache com hora desconhecida até o NTP
 
 // ============================================================
 // SETUP
@@ -128,26 +720,64 @@ void setup() {
   pinMode(38, OUTPUT);
   digitalWrite(38, HIGH);
 
-  tft.fillScreen(COL_BG);
+  pinMode(BTN_PIN, INPUT_PULLUP);
+
+  // setup() e loop() rodam na mesma task (loopTask)
+  renderTaskHandle = xTaskGetCurrentTaskHandle();
+  attachInterrupt(digitalPinToInterrupt(BTN_PIN), onButtonEdge, CHANGE);
+
+  tft.fillScreen(PALETTE_RGB565[PAL_BG]);
+
+  createFrameSprite(frames[0]);
+  buildPaletteTables();
+  buildGlyphAtlas();
+
+#if FRAME_ASYNC_PUSH
+  // Segundo buffer + task de push; sem memória fica no push síncrono
+  if (createFrameSprite(frames[1])) {
+    pushStart = xSemaphoreCreateBinary();
+    pushDone  = xSemaphoreCreateBinary();
+    xSemaphoreGive(pushDone);
+    xTaskCreatePinnedToCore(pushTask, "push", PUSH_STACK, nullptr,
+                            PUSH_PRIORITY, nullptr, PUSH_CORE);
+    asyncPush = true;
+  }
+#endif
+
+  // Serial chega mesmo durante o boot bloqueante (WiFi)
+  xTaskCreatePinnedToCore(ingestTask, "ingest", INGEST_STACK, nullptr,
+                          INGEST_PRIORITY, nullptr, INGEST_CORE);
 
-  spr.createSprite(SCREEN_W, SCREEN_H);
-  spr.setTextDatum(TL_DATUM);
+  netRequests = xQueueCreate(NET_QUEUE_LEN, sizeof(NetRequest));
+  netResults  = xQueueCreate(NET_QUEUE_LEN, sizeof(NetResult));
+  xTaskCreatePinnedToCore(netTask, "net", NET_STACK, nullptr,
+                          NET_PRIORITY, nullptr, NET_CORE);
 
-  // Boot screen: conectando WiFi
-  drawBootScreen("Conectando WiFi...");
+  // Com cache a tela idle completa aparece já, antes do WiFi;
+  // sem cache (primeiro boot) fica a tela de boot
+  wifiConnecting = true;
+  if (bootCacheLoad()) {
+    drawIdleScreen();
+  } else {
+    drawBootScreen("Conectando WiFi...");
+  }
   setupWiFi();
+  wifiConnecting = false;
 
   if (wifiConnected) {
-    drawBootScreen("Sincronizando relogio...");
     syncNTP();
-    drawBootScreen("Buscando clima...");
-    fetchLocation();
-    fetchWeather();
   } else {
     drawConfigScreen();
   }
 
   lastDataTime = millis();
+
+  // Tarefas periódicas partem agora; hora e clima chegam em segundo
+  // plano enquanto a tela idle já roda
+  schedIn(SCHED_INGEST, 0);
+  schedIn(SCHED_LINK, 0);
+  schedIn(SCHED_TIME, 0);
+  schedIn(SCHED_WEATHER, 0);
 }
 
 // ============================================================
@@ -173,339 +803,1476 @@ void setupWiFi() {
 // NTP
 // ============================================================
 void syncNTP() {
+  // Não bloqueia: runTime() confere quando a hora chegou
   configTime(GMT_OFFSET, DST_OFFSET, NTP_SERVER);
-
-  struct tm timeinfo;
-  if (getLocalTime(&timeinfo, 5000)) {
-    ntpSynced = true;
-  }
+  ntpStarted = true;
 }
 
-void updateNtpTime() {
+bool updateNtpTime() {
   // Atualiza hora/data do NTP local (sem rede, struct tm é mantido pelo ESP32)
+  // Retorna true se o texto mudou (virada do minuto)
   struct tm timeinfo;
-  if (getLocalTime(&timeinfo, 0)) {
-    strftime(hw.hora, sizeof(hw.hora), "%H:%M", &timeinfo);
-    strftime(hw.data, sizeof(hw.data), "%d %b", &timeinfo);
-  }
+  if (!getLocalTime(&timeinfo, 0)) return false;
+
+  char hora[sizeof(hw.hora)], data[sizeof(hw.data)];
+  strftime(hora, sizeof(hora), "%H:%M", &timeinfo);
+  strftime(data, sizeof(data), "%d %b", &timeinfo);
+
+  // Roda de novo na próxima virada de minuto
+  schedIn(SCHED_TIME, (60 - timeinfo.tm_sec) * 1000UL);
+
+  if (!strcmp(hora, hw.hora) && !strcmp(data, hw.data)) return false;
+  strcpy(hw.hora, hora);
+  strcpy(hw.data, data);
+  return true;
 }
 
 // ============================================================
 // CLIMA — geolocalização por IP + Open-Meteo
 // ============================================================
-void fetchLocation() {
+// Heap durante uma busca. drop é a queda da heap livre GLOBAL entre
+// o início e o ponto mais baixo: amostrada no GET, a cada
+// HEAP_SAMPLE_BYTES do corpo e no fim, mais o mínimo histórico do
+// heap_caps (getMinFreeHeap) se ele caiu no meio (o vale do handshake
+// TLS, dentro do GET()). Render, ingestão e WiFi alocam ao mesmo
+// tempo, então não é um número só da busca. body são os bytes da
+// resposta que o próprio parse guardou na heap (a String do caminho
+// antigo; 0 no streaming), esses sim por busca.
+static const uint16_t HEAP_SAMPLE_BYTES = 64;
+
+struct HeapWatch {
+  uint32_t start = ESP.getFreeHeap();
+  uint32_t low = start;
+  uint32_t minStart = ESP.getMinFreeHeap();
+  uint32_t body = 0;
+
+  void sample() { low = min(low, ESP.getFreeHeap()); }
+
+  uint32_t drop() {
+    sample();
+    uint32_t minNow = ESP.getMinFreeHeap();
+    if (minNow < minStart) low = min(low, minNow);
+    return start - low;
+  }
+};
+
+#if HTTP_STREAM_JSON
+// Leitor do ArduinoJson sobre o socket que amostra a heap enquanto o
+// corpo chega (o TLS decifra e aloca registro a registro)
+struct HeapSampledStream {
+  Stream&    in;
+  HeapWatch& heap;
+  uint16_t   n = 0;
+
+  int read() {
+    if (++n % HEAP_SAMPLE_BYTES == 0) heap.sample();
+    char c;
+    return in.readBytes(&c, 1) ? (uint8_t)c : -1;  // com o timeout do stream
+  }
+  size_t readBytes(char* buf, size_t len) {
+    heap.sample();
+    return in.readBytes(buf, len);
+  }
+};
+#endif
+
+static DeserializationError readJson(HTTPClient& http, JsonDocument& doc,
+                                     const JsonDocument& filter, HeapWatch& heap) {
+#if HTTP_STREAM_JSON
+  HeapSampledStream body{http.getStream(), heap};
+  return deserializeJson(doc, body, DeserializationOption::Filter(filter));
+#else
+  String body = http.getString();
+  heap.sample();  // corpo inteiro na heap
+  heap.body = body.length() + 1;
+  return deserializeJson(doc, body);
+#endif
+}
+
+static void httpGet(HTTPClient& http, const char* url, NetResult& r, HeapWatch& heap) {
+  // HTTP/1.0: resposta sem chunks, o stream é o próprio corpo
+  http.begin(url);
+  http.setTimeout(HTTP_TIMEOUT_MS);
+  if (HTTP_STREAM_JSON) http.useHTTP10(true);
+  r.status = http.GET();
+  heap.sample();
+}
+
+static void fetchLocation(NetResult& r) {
+  StaticJsonDocument<32> filter;
+  filter["lat"] = true;
+  filter["lon"] = true;
+
+  HeapWatch heap;
   HTTPClient http;
-  http.begin("http://ip-api.com/json/?fields=lat,lon");
-  http.setTimeout(5000);
-
-  int code = http.GET();
-  if (code == 200) {
-    StaticJsonDocument<128> doc;
-    if (!deserializeJson(doc, http.getString())) {
-      weatherLat = doc["lat"] | 0.0f;
-      weatherLon = doc["lon"] | 0.0f;
+  httpGet(http, LOCATION_URL, r, heap);
+  if (r.status == 200) {
+    StaticJsonDocument<LOCATION_DOC> doc;
+    if (readJson(http, doc, filter, heap)) {
+      r.status = NET_ERR_PARSE;
+    } else {
+      r.lat = doc["lat"] | 0.0f;
+      r.lon = doc["lon"] | 0.0f;
     }
   }
+  r.heapDrop = heap.drop();
+  r.bodyHeap = heap.body;
   http.end();
 }
 
-void fetchWeather() {
-  if (weatherLat == 0 && weatherLon == 0) return;
-
+static void fetchWeather(float lat, float lon, NetResult& r) {
   char url[160];
   snprintf(url, sizeof(url),
-    "https://api.open-meteo.com/v1/forecast?latitude=%.4f&longitude=%.4f"
-    "&current=temperature_2m,weather_code",
-    weatherLat, weatherLon);
+    "%s?latitude=%.4f&longitude=%.4f&current=temperature_2m,weather_code",
+    WEATHER_URL, lat, lon);
+
+  StaticJsonDocument<64> filter;
+  filter["current"]["temperature_2m"] = true;
+  filter["current"]["weather_code"]   = true;
 
+  HeapWatch heap;
   HTTPClient http;
-  http.begin(url);
-  http.setTimeout(5000);
-
-  int code = http.GET();
-  if (code == 200) {
-    StaticJsonDocument<512> doc;
-    if (!deserializeJson(doc, http.getString())) {
-      weatherTemp = (int)round((float)(doc["current"]["temperature_2m"] | 0.0));
-      weatherCode = doc["current"]["weather_code"] | -1;
-      weatherValid = true;
-      lastWeatherUpdate = millis();
+  httpGet(http, url, r, heap);
+  if (r.status == 200) {
+    StaticJsonDocument<WEATHER_DOC> doc;
+    if (readJson(http, doc, filter, heap)) {
+      r.status = NET_ERR_PARSE;
+    } else {
+      r.temp = (int)round((float)(doc["current"]["temperature_2m"] | 0.0));
+      r.code = doc["current"]["weather_code"] | -1;
     }
   }
+  r.heapDrop = heap.drop();
+  r.bodyHeap = heap.body;
   http.end();
 }
 
+void netTask(void* arg) {
+  // Um pedido por vez; o resultado volta ao loop com uma notificação
+  NetRequest req;
+  for (;;) {
+    xQueueReceive(netRequests, &req, portMAX_DELAY);
+
+    NetResult res = {};
+    res.job  = req.job;
+    res.done = req.done;
+    uint32_t t0 = millis();
+    if (req.job == NET_LOCATION) {
+      fetchLocation(res);
+    } else {
+      fetchWeather(req.lat, req.lon, res);
+    }
+    res.ms = millis() - t0;
+
+    xQueueSend(netResults, &res, portMAX_DELAY);
+    if (renderTaskHandle) xTaskNotifyGive(renderTaskHandle);
+  }
+}
+
+bool netRequest(NetJob job, NetCallback done, float lat, float lon) {
+  // Um pedido de cada tipo por vez; repetir enquanto corre é no-op
+  if (netPending[job]) return true;
+  NetRequest req = { job, lat, lon, done };
+  if (xQueueSend(netRequests, &req, 0) != pdTRUE) return false;
+  netPending[job] = true;
+  return true;
+}
+
+// ── Política de busca ──
+static unsigned long fetchBackoff(uint8_t failures) {
+  // 30 s, 60 s, 2 min... até 30 min; metade do prazo é aleatória
+  if (failures >= FETCH_FAILURE_BUDGET) return FETCH_BACKOFF_MAX;
+  unsigned long d = min(FETCH_BACKOFF_MAX, FETCH_BACKOFF_BASE << (failures - 1));
+  return d / 2 + random(d / 2 + 1);
+}
+
+static void fetchDone(const NetResult& r, bool ok, unsigned long okInterval) {
+  // Atualiza o endpoint e agenda a próxima tentativa do clima
+  FetchPolicy& p = fetchPolicy[r.job];
+  unsigned long now = millis();
+  p.lastStatus = r.status;
+  p.heapDrop   = max(p.heapDrop, r.heapDrop);
+  p.bodyHeap   = max(p.bodyHeap, r.bodyHeap);
+  if (ok) {
+    p.failures = 0;
+    p.lastOkAt = now;
+    p.nextAt   = now + okInterval;
+  } else {
+    if (p.failures < 255) p.failures++;
+    p.nextAt = now + fetchBackoff(p.failures);
+  }
+  schedAt(SCHED_WEATHER, p.nextAt);
+}
+
+void fetchPolicyReset() {
+  // WiFi voltou: o orçamento de falhas recomeça (quem está em dia
+  // continua esperando o intervalo normal)
+  for (int i = 0; i < NET_JOBS; i++) {
+    if (!fetchPolicy[i].failures) continue;
+    fetchPolicy[i].failures = 0;
+    fetchPolicy[i].nextAt   = millis();
+  }
+}
+
+// ── Cache de boot ──
+static void weatherCacheAge(uint32_t now) {
+  // Converte o epoch do clima em cache para a base do millis()
+  uint32_t age = now - bootCache.wxAt;
+  weatherAgeKnown = true;
+  if (now < bootCache.wxAt || age >= WEATHER_MAX_AGE / 1000) {
+    weatherValid = false;  // velho demais (ou do futuro): só a busca nova
+    fetchPolicy[NET_WEATHER].nextAt = millis();
+    return;
+  }
+  lastWeatherUpdate = millis() - age * 1000UL;
+  fetchPolicy[NET_WEATHER].nextAt = age * 1000UL < WEATHER_INTERVAL
+                                    ? lastWeatherUpdate + WEATHER_INTERVAL : millis();
+}
+
+bool bootCacheLoad() {
+  // Retorna true se há algo para mostrar (clima) na tela idle
+  unsigned long now = millis();
+  fetchPolicy[NET_LOCATION].nextAt = now;
+  fetchPolicy[NET_WEATHER].nextAt  = now;
+
+  // Hora no reset por software: o IDF mantém a hora do sistema (timer da
+  // RTC), que vale mais que rtcClock.epoch (gravado até 1 min antes).
+  // rtcClock só entra se a hora do sistema ainda não é válida
+  bool sysValid = time(nullptr) >= EPOCH_VALID_MIN;
+  bool rtcValid = rtcClock.magic == RTC_CLOCK_MAGIC && rtcClock.epoch >= EPOCH_VALID_MIN;
+  if (sysValid || rtcValid) {
+    char tz[16];
+    snprintf(tz, sizeof(tz), "UTC%+ld:%02ld", -GMT_OFFSET / 3600, labs(GMT_OFFSET % 3600) / 60);
+    setenv("TZ", tz, 1);
+    tzset();
+    if (!sysValid) {
+      timeval tv = { (time_t)rtcClock.epoch, 0 };
+      settimeofday(&tv, nullptr);
+    }
+    ntpSynced = true;  // hora utilizável; o SNTP acerta quando o WiFi subir
+    updateNtpTime();
+  }
+
+  Preferences prefs;
+  BootCache c;
+  bool ok = prefs.begin(BOOT_CACHE_NS, true) &&
+            prefs.getBytes(BOOT_CACHE_KEY, &c, sizeof(c)) == sizeof(c) &&
+            c.version == BOOT_CACHE_VERSION;
+  prefs.end();
+  if (!ok) return false;
+  bootCache = c;
+
+  if (c.lat != 0 || c.lon != 0) {
+    weatherLat = c.lat;
+    weatherLon = c.lon;
+    locationStale = !c.locAt;  // gravada sem hora: idade desconhecida
+  }
+  if (c.code >= 0) {
+    weatherTemp  = c.temp;
+    weatherCode  = c.code;
+    weatherValid = true;
+    lastWeatherUpdate = now;
+    weatherAgeKnown = false;  // até saber a hora
+  }
+  if (ntpSynced) clockBecameValid();
+  return weatherValid;
+}
+
+void bootCacheSave() {
+  Preferences prefs;
+  if (!prefs.begin(BOOT_CACHE_NS, false)) return;
+  prefs.putBytes(BOOT_CACHE_KEY, &bootCache, sizeof(bootCache));
+  prefs.end();
+}
+
+void clockBecameValid() {
+  // Agora dá para saber a idade do que veio do cache. Clima gravado
+  // sem hora (wxAt 0) tem idade desconhecida: weatherCacheAge o vê
+  // velho demais e o tira da tela
+  uint32_t now = (uint32_t)time(nullptr);
+  if (!weatherAgeKnown) weatherCacheAge(now);
+  if (bootCache.locAt && (now < bootCache.locAt || now - bootCache.locAt > LOCATION_MAX_AGE_S)) {
+    locationStale = true;
+  }
+
+  // O que foi buscado neste boot antes do NTP foi gravado com hora 0;
+  // carimba agora, senão nunca envelhece (nem na tela, nem no cache)
+  bool stamped = false;
+  if (!bootCache.locAt && (bootCache.lat != 0 || bootCache.lon != 0) && !locationStale) {
+    bootCache.locAt = now;
+    stamped = true;
+  }
+  if (!bootCache.wxAt && bootCache.code >= 0 && weatherValid) {
+    bootCache.wxAt = now - (millis() - lastWeatherUpdate) / 1000;
+    stamped = true;
+  }
+  if (stamped) bootCacheSave();
+  frameDirty = true;
+}
+
+// ── Callbacks (rodam no loop) ──
+static void onLocation(const NetResult& r) {
+  bool ok = r.status == 200 && (r.lat != 0 || r.lon != 0);
+  if (ok) {
+    weatherLat = r.lat;
+    weatherLon = r.lon;
+    locationStale = false;
+    bootCache.lat = r.lat;
+    bootCache.lon = r.lon;
+    bootCache.locAt = ntpSynced ? (uint32_t)time(nullptr) : 0;
+    bootCacheSave();
+  }
+  fetchDone(r, ok, 0);  // sucesso: clima em seguida
+}
+
+static void onWeather(const NetResult& r) {
+  bool ok = r.status == 200;
+  if (ok) {
+    weatherTemp = r.temp;
+    weatherCode = r.code;
+    weatherValid = true;
+    weatherAgeKnown = true;
+    lastWeatherUpdate = millis();
+    frameDirty = true;
+    bootCache.temp = r.temp;
+    bootCache.code = r.code;
+    bootCache.wxAt = ntpSynced ? (uint32_t)time(nullptr) : 0;
+    bootCacheSave();
+  }
+  // Falha mantém o último clima (com a idade na tela)
+  fetchDone(r, ok, WEATHER_INTERVAL);
+}
+
 // ============================================================
-// LOOP
+// LOOP — agendador cooperativo
 // ============================================================
 void loop() {
+  // Ingestão, botão e rede notificam a task
+  if (ulTaskNotifyTake(pdTRUE, 0)) schedKick();
+  if (frameDirty) schedIn(SCHED_RENDER, 0);
+
+  int id = schedNext();
+  if (id >= 0) {
+    schedRun((SchedId)id);
+  } else {
+    schedSleep(LOOP_MAX_SLEEP_MS);
+  }
+}
+
+// ── Tarefas ──
+static void runIngest() {
+  // Lado do loop da ingestão: snapshot, amostras dos gráficos e botão
+  if (checkButton()) frameDirty = true;
+  // Botão mudou dentro do debounce: confere de novo quando vencer
+  if (digitalRead(BTN_PIN) != btnLevel) schedIn(SCHED_INGEST, BTN_DEBOUNCE_MS);
+
+  // Pega o snapshot mais recente publicado pela task de ingestão
+  if (telemetryRead(hw)) {
+    lastDataTime = millis();
+    hasSerialData = true;
+    frameDirty = true;
+    schedIn(SCHED_LINK, 0);  // modo gaming/idle reage ao snapshot
+  }
+  drainSamples();
+  if (drainFrameTimes()) frameDirty = true;
+}
+
+static void runRender() {
+  frameDirty = false;
+  frameStartUs = micros();
+  frameStartTick = profNow() | 1;  // nunca 0
+
+  // Sem WiFi o portal está aberto: só a tela de config
+  if (!wifiConnected) {
+    drawConfigScreen();
+  } else if (inGamingMode) {
+    drawGamingScreen();
+  } else {
+    drawIdleScreen();
+  }
+}
+
+static void runNet() {
+  // Resultados da task de rede: callbacks rodam aqui, no loop
+  NetResult res;
+  while (xQueueReceive(netResults, &res, 0) == pdTRUE) {
+    netPending[res.job] = false;
+    if (res.done) res.done(res);
+  }
+}
+
+static void runLink() {
   // Se WiFi não conectou, processa o portal captive
   if (!wifiConnected) {
     wm.process();
-
-    // Checa se conectou agora
     if (WiFi.status() == WL_CONNECTED) {
       wifiConnected = true;
-      drawBootScreen("Sincronizando relogio...");
-      syncNTP();
-      drawBootScreen("Buscando clima...");
-      fetchLocation();
-      fetchWeather();
+      frameDirty = true;
+      fetchPolicyReset();
+      schedIn(SCHED_TIME, 0);
+      schedIn(SCHED_WEATHER, 0);
     } else {
-      // Redesenha tela de config periodicamente (animação)
-      static unsigned long lastConfigDraw = 0;
-      if (millis() - lastConfigDraw > 500) {
-        lastConfigDraw = millis();
-        drawConfigScreen();
-      }
-      delay(50);
-      return;
+      schedIn(SCHED_LINK, PORTAL_POLL_MS);
     }
-  }
-
-  // Reconecta WiFi se caiu
-  if (WiFi.status() != WL_CONNECTED) {
+  } else if (WiFi.status() != WL_CONNECTED) {
+    // Reconecta WiFi se caiu
     wifiConnected = false;
     WiFi.reconnect();
+    frameDirty = true;
+    schedIn(SCHED_LINK, PORTAL_POLL_MS);
   }
 
-  // Atualiza clima a cada 15 min
-  if (wifiConnected && (millis() - lastWeatherUpdate > WEATHER_INTERVAL)) {
-    fetchWeather();
+  // Serial ativa: confere de novo quando o timeout vencer
+  bool serialActive = serialLinkActive();
+  if (serialActive) schedAt(SCHED_LINK, lastDataTime + SERIAL_TIMEOUT_MS);
+
+  // Auto-switch gaming/idle
+  if (hw.fps > 0 && serialActive) {
+    inGamingMode = true;
+    lastFpsTime = millis();
+  } else if (inGamingMode && (millis() - lastFpsTime > GAMING_COOLDOWN_MS)) {
+    inGamingMode = false;
+  } else if (inGamingMode) {
+    schedAt(SCHED_LINK, lastFpsTime + GAMING_COOLDOWN_MS + 1);
   }
 
-  readSerial();
+  // Rodapé e tela dependem destes estados, não só de hw
+  static bool lastSerialActive = false, lastGaming = false;
+  if (serialActive != lastSerialActive || inGamingMode != lastGaming) {
+    // Serial caiu: o relógio volta a vir do NTP
+    if (serialActive != lastSerialActive) schedIn(SCHED_TIME, 0);
+    lastSerialActive = serialActive;
+    lastGaming = inGamingMode;
+    frameDirty = true;
+  }
+}
 
-  // Verifica se serial está ativa
-  bool serialActive = (millis() - lastDataTime < SERIAL_TIMEOUT_MS) && hasSerialData;
+static void runTime() {
+  if (wifiConnected && !ntpStarted) syncNTP();
+  if (!ntpSynced) {
+    // SNTP ligado, hora ainda não chegou: confere de novo logo
+    struct tm timeinfo;
+    if (!ntpStarted) return;
+    if (!getLocalTime(&timeinfo, 0)) {
+      schedIn(SCHED_TIME, NTP_POLL_MS);
+      return;
+    }
+    ntpSynced = true;
+    clockBecameValid();
+  }
+  rtcClock = RtcClock{ RTC_CLOCK_MAGIC, (uint32_t)time(nullptr) };
 
   // Se não tem serial, usa hora do NTP
-  if (!serialActive && ntpSynced) {
-    if (millis() - lastNtpUpdate > NTP_UPDATE_INTERVAL) {
-      lastNtpUpdate = millis();
-      updateNtpTime();
+  if (!serialLinkActive() && ntpSynced && updateNtpTime()) frameDirty = true;
+}
+
+static void runWeather() {
+  // Só enfileira; onLocation()/onWeather() agendam a próxima vez.
+  // Sem WiFi fica parada; runLink() agenda ao conectar
+  if (!wifiConnected) return;
+
+  // ip-api só sem localização ou com o cache dela velho; com cache
+  // velho o clima continua usando as coordenadas antigas
+  bool haveLocation = weatherLat != 0 || weatherLon != 0;
+  bool queued = true;
+  for (int job = 0; job < NET_JOBS; job++) {
+    bool wanted = (job == NET_LOCATION) ? !haveLocation || locationStale : haveLocation;
+    if (!wanted || netPending[job]) continue;
+
+    const FetchPolicy& p = fetchPolicy[job];
+    if ((long)(millis() - p.nextAt) < 0) {
+      schedAt(SCHED_WEATHER, p.nextAt);  // ainda em backoff (ou clima em dia)
+      continue;
     }
-    // Atualiza hora a cada frame se não tem serial
-    updateNtpTime();
+    queued &= (job == NET_LOCATION)
+              ? netRequest(NET_LOCATION, onLocation)
+              : netRequest(NET_WEATHER, onWeather, weatherLat, weatherLon);
   }
+  if (!queued) schedIn(SCHED_WEATHER, FETCH_BACKOFF_BASE);
+}
 
-  // Auto-switch gaming/idle
-  if (hw.fps > 0 && serialActive) {
-    inGamingMode = true;
-    lastFpsTime = millis();
-  } else if (inGamingMode && (millis() - lastFpsTime > GAMING_COOLDOWN_MS)) {
-    inGamingMode = false;
+// Na ordem de SCHED_TASKS
+static void (*const SCHED_RUN[])() = {
+  runIngest, runRender, runNet, runLink, runTime, runWeather,
+};
+static_assert(sizeof(SCHED_RUN) / sizeof(SCHED_RUN[0]) == SCHED_COUNT,
+              "SCHED_RUN fora de sincronia com SCHED_TASKS");
+
+// ── Agendador ──
+void schedAt(SchedId id, unsigned long at) {
+  // Prazo mais cedo vence; nunca antes do intervalo mínimo da tarefa
+  SchedTask& t = sched[id];
+  unsigned long gap = SCHED_DEFS[id].gap;
+  if (gap && t.runs && (long)(at - (t.lastStart + gap)) < 0) at = t.lastStart + gap;
+  if (!t.armed || (long)(at - t.due) < 0) {
+    t.due = at;
+    t.armed = true;
   }
+}
 
-  // Sempre mostra algo: gaming ou idle (nunca "offline")
-  if (inGamingMode) {
-    drawGamingScreen();
-  } else {
-    drawIdleScreen();
+void schedIn(SchedId id, unsigned long ms) {
+  schedAt(id, millis() + ms);
+}
+
+void schedKick() {
+  // Notificação da task: snapshot novo, botão ou resposta da rede
+  schedIn(SCHED_INGEST, 0);
+  schedIn(SCHED_NET, 0);
+}
+
+int schedNext() {
+  // Vencida de maior prioridade; empate: prazo mais antigo
+  unsigned long now = millis();
+  int best = -1;
+  for (int i = 0; i < SCHED_COUNT; i++) {
+    const SchedTask& t = sched[i];
+    if (!t.armed || (long)(now - t.due) < 0) continue;
+    if (best < 0 || SCHED_DEFS[i].priority < SCHED_DEFS[best].priority ||
+        (SCHED_DEFS[i].priority == SCHED_DEFS[best].priority &&
+         (long)(t.due - sched[best].due) < 0)) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+void schedRun(SchedId id) {
+  SchedTask& t = sched[id];
+  const SchedDef& d = SCHED_DEFS[id];
+  unsigned long now = millis();
+  latencyAdd(t.late, t.due);
+
+  // Periódica: próximo prazo relativo ao anterior (sem deriva); se
+  // atrasou mais de um período, recomeça a partir de agora
+  t.armed = false;
+  if (d.period) {
+    unsigned long next = t.due + d.period;
+    if ((long)(next - now) <= 0) next = now + d.period;
+    t.due = next;
+    t.armed = true;
+  }
+  t.lastStart = now;
+
+  // A tarefa pode se reagendar para antes (schedAt fica com o menor)
+  uint32_t t0 = micros();
+  SCHED_RUN[id]();
+  t.lastUs = micros() - t0;
+  t.maxUs = max(t.maxUs, t.lastUs);
+  if (t.lastUs > d.budgetUs) t.overruns++;
+  t.runs++;
+}
+
+void schedSleep(unsigned long maxSleep) {
+  // Dorme até o próximo prazo; ingestão (snapshot novo), botão e
+  // rede acordam antes
+  unsigned long now = millis();
+  unsigned long wait = maxSleep;
+  for (int i = 0; i < SCHED_COUNT; i++) {
+    if (!sched[i].armed) continue;
+    long left = (long)(sched[i].due - now);
+    wait = min(wait, (unsigned long)max(0L, left));
   }
+  if (wait == 0) return;
+  if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait))) schedKick();
+}
+
+// ── Render ──
+void scheduleFrameIn(unsigned long ms) {
+  schedIn(SCHED_RENDER, ms);
+}
+
+void scheduleFrameTick(unsigned long period) {
+  // Próxima borda de período: a fase da animação muda exatamente aí
+  scheduleFrameIn(period - millis() % period);
+}
+
+// ============================================================
+// BOTÃO — alterna as páginas do overlay de debug
+// ============================================================
+void IRAM_ATTR onButtonEdge() {
+  // Só acorda o loop; o debounce fica em checkButton()
+  BaseType_t woken = pdFALSE;
+  if (renderTaskHandle) vTaskNotifyGiveFromISR(renderTaskHandle, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+bool checkButton() {
+  // Retorna true quando a página do overlay mudou
+  int level = digitalRead(BTN_PIN);
+  if (level == btnLevel || millis() - btnChangedAt < BTN_DEBOUNCE_MS) return false;
+  btnChangedAt = millis();
+  btnLevel = level;
+
+  if (level != LOW) return false;
+  debugPage = (debugPage + 1) % DEBUG_PAGES;
+  return true;
+}
+
+// ============================================================
+// INGESTÃO — task + hand-off para o render
+// ============================================================
+static void updateLinkRates() {
+  unsigned long now = millis();
+  unsigned long elapsed = now - rateWindowStart;
+  if (elapsed < LINK_RATE_WINDOW) return;
+
+  uint32_t bytes = linkStats.rxBytes;
+  uint32_t msgs  = linkStats.messages;
+  linkStats.bytesPerSec = (uint32_t)((uint64_t)(bytes - rateBytesMark) * 1000 / elapsed);
+  linkStats.msgsPerSec  = (uint32_t)((uint64_t)(msgs - rateMsgsMark) * 1000 / elapsed);
+  rateBytesMark = bytes;
+  rateMsgsMark  = msgs;
+  rateWindowStart = now;
+}
+
+static void clockPing() {
+  // Só com host ativo: sem ninguém lendo, o buffer USB encheria
+  if (linkStats.messages == 0 || millis() - lastMessageAt > SERIAL_TIMEOUT_MS) return;
+
+  unsigned long period = hostClock.synced ? CLOCK_PING_PERIOD : CLOCK_PING_FAST;
+  if (millis() - hostClock.lastPing < period) return;
+  hostClock.lastPing = millis();
+  Serial.printf("{\"evt\":\"ping\",\"t0\":%lu}\n", (unsigned long)hostClock.lastPing);
+}
+
+static void clockPong(uint32_t t0, uint32_t t1) {
+  HostClock& c = hostClock;
+  uint32_t rtt = millis() - t0;
+  if (rtt > CLOCK_RTT_MAX) return;  // pong atrasado ou de outro boot
+
+  // Supõe ida e volta simétricas: t1 corresponde ao meio do RTT
+  uint32_t mid = t0 + rtt / 2;
+  if (rtt < c.bestRtt) {
+    c.bestRtt    = rtt;
+    c.bestOffset = t1 - mid;
+    c.bestMid    = mid;
+  }
+  if (++c.pings < CLOCK_WINDOW) return;
+
+  if (!c.synced) {
+    c.anchorOffset = c.bestOffset;
+    c.anchorMid    = c.bestMid;
+  } else if (c.bestMid - c.anchorMid >= CLOCK_DRIFT_SPAN) {
+    float d = (float)(int32_t)(c.bestOffset - c.anchorOffset) / (float)(c.bestMid - c.anchorMid);
+    if (fabsf(d) > CLOCK_DRIFT_MAX) {
+      c.drift = 0;
+      c.driftValid = false;
+    } else {
+      c.drift = c.driftValid ? c.drift + (d - c.drift) * 0.25f : d;
+      c.driftValid = true;
+    }
+    c.anchorOffset = c.bestOffset;
+    c.anchorMid    = c.bestMid;
+  }
+
+  c.offset = c.bestOffset;
+  c.ref    = c.bestMid;
+  c.rtt    = c.bestRtt;
+  c.synced = true;
+  c.pings  = 0;
+  c.bestRtt = UINT32_MAX;
+}
+
+static uint32_t hostToLocal(uint32_t hostMs) {
+  // offset(t) = offset + drift·(t − ref)
+  uint32_t t = hostMs - hostClock.offset;
+  return t - (int32_t)(hostClock.drift * (float)(int32_t)(t - hostClock.ref));
+}
+
+void latencyAdd(LatencyRing& r, uint32_t sampledAt) {
+  int32_t ms = (int32_t)(millis() - sampledAt);
+  r.v[r.head] = (uint16_t)constrain(ms, 0, 65535);  // negativo = erro do offset
+  r.head = (r.head + 1) % LAT_SAMPLES;
+  if (r.count < LAT_SAMPLES) r.count++;
+}
+
+LatencyPct latencyPercentiles(const LatencyRing& r) {
+  uint16_t v[LAT_SAMPLES];
+  int n = r.count;
+  if (n == 0) return LatencyPct{0, 0, 0};
+  memcpy(v, r.v, sizeof(v));
+  std::sort(v, v + n);
+  return LatencyPct{ v[n * 50 / 100], v[n * 95 / 100], v[n * 99 / 100] };
+}
+
+void profCommit(ProfStage s) {
+  profRingCommit(prof[s]);
+}
+
+ProfStat profStat(ProfStage s) {
+  return profRingStat(prof[s], profTicksPerUs());
+}
+
+static void profRenderDone() {
+  // Só frames agendados por frameDue(); as telas de boot não contam
+  if (!PROFILER || !frameStartTick) return;
+  prof[PROF_FRAME].acc = profNow() - frameStartTick;
+  prof[PROF_FRAME].ran = true;
+  frameStartTick = 0;
+}
+
+static void profEndFrame() {
+  // TEXT é o que sobrou do render fora dos escopos próprios
+  ProfRing& f = prof[PROF_FRAME];
+  if (f.ran) {
+    uint32_t scoped = prof[PROF_CLEAR].acc + prof[PROF_GLYPH].acc +
+                      prof[PROF_ART].acc + prof[PROF_GRAPH].acc +
+                      prof[PROF_OVERLAY].acc;
+    prof[PROF_TEXT].acc = f.acc - min(scoped, f.acc);
+    prof[PROF_TEXT].ran = true;
+  }
+  for (int i = PROF_FRAME; i <= PROF_FENCE; i++) profCommit((ProfStage)i);
+}
+
+static void sendLinkStats() {
+  LatencyPct lp = latencyPercentiles(latParse);
+  LatencyPct ls = latencyPercentiles(latPush);
+  const FetchPolicy& wx = fetchPolicy[NET_WEATHER];
+  Serial.printf("{\"evt\":\"stats\",\"rx_bytes\":%lu,\"bps\":%lu,\"mps\":%lu,"
+                "\"msgs\":%lu,\"gap_ms\":%lu,\"json_err\":%lu,\"frame_err\":%lu,"
+                "\"crc_err\":%lu,\"overflow\":%lu,\"seq_gaps\":%lu,"
+                "\"delta_drops\":%lu,\"kf_req\":%lu,\"sample_drops\":%lu,"
+                "\"clk_sync\":%d,\"clk_rtt\":%lu,\"drift_ppm\":%.1f,"
+                "\"lat_parse\":[%u,%u,%u],\"lat_push\":[%u,%u,%u],"
+                "\"render_us\":%lu,\"push_us\":%lu,\"fence_us\":%lu,\"async_push\":%d,"
+                "\"wx_age_s\":%ld,\"wx_fail\":%u,\"wx_status\":%d,"
+                "\"net_heap\":[%lu,%lu],\"net_body\":[%lu,%lu],\"heap_free\":%lu,\"heap_min\":%lu}\n",
+                (unsigned long)linkStats.rxBytes, (unsigned long)linkStats.bytesPerSec,
+                (unsigned long)linkStats.msgsPerSec, (unsigned long)linkStats.messages,
+                (unsigned long)linkStats.lastGapMs, (unsigned long)linkStats.jsonErrors,
+                (unsigned long)linkStats.frameErrors, (unsigned long)linkStats.crcErrors,
+                (unsigned long)linkStats.overflows, (unsigned long)linkStats.seqGaps,
+                (unsigned long)linkStats.deltaDrops, (unsigned long)linkStats.keyframeReqs,
+                (unsigned long)linkStats.sampleDrops,
+                hostClock.synced, (unsigned long)hostClock.rtt, hostClock.drift * 1e6f,
+                lp.p50, lp.p95, lp.p99, ls.p50, ls.p95, ls.p99,
+                (unsigned long)renderUs, (unsigned long)pushUs, (unsigned long)fenceUs, asyncPush,
+                weatherValid ? (long)((millis() - lastWeatherUpdate) / 1000) : -1L,
+                wx.failures, wx.lastStatus,
+                (unsigned long)fetchPolicy[NET_LOCATION].heapDrop, (unsigned long)wx.heapDrop,
+                (unsigned long)fetchPolicy[NET_LOCATION].bodyHeap, (unsigned long)wx.bodyHeap,
+                (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap());
+}
+
+static void sendProfile() {
+  // {"evt":"prof","unit":"us","n":64,"frame":[min,avg,p99],...}
+  Serial.printf("{\"evt\":\"prof\",\"unit\":\"us\",\"n\":%d", PROF_SAMPLES);
+  for (int i = 0; i < PROF_COUNT; i++) {
+    ProfStat st = profStat((ProfStage)i);
+    Serial.printf(",\"%s\":[%lu,%lu,%lu]", PROF_NAMES[i],
+                  (unsigned long)st.min, (unsigned long)st.avg, (unsigned long)st.p99);
+  }
+  Serial.print("}\n");
+}
+
+static void sendSchedule() {
+  // {"evt":"sched","render":{"runs":N,"late":[p50,p95,p99],"max_us":N,"budget_us":N,"over":N},...}
+  Serial.print("{\"evt\":\"sched\"");
+  for (int i = 0; i < SCHED_COUNT; i++) {
+    const SchedTask& t = sched[i];
+    LatencyPct lp = latencyPercentiles(t.late);
+    Serial.printf(",\"%s\":{\"runs\":%lu,\"late\":[%u,%u,%u],\"max_us\":%lu,"
+                  "\"budget_us\":%lu,\"over\":%lu}",
+                  SCHED_DEFS[i].name, (unsigned long)t.runs, lp.p50, lp.p95, lp.p99,
+                  (unsigned long)t.maxUs, (unsigned long)SCHED_DEFS[i].budgetUs,
+                  (unsigned long)t.overruns);
+  }
+  Serial.print("}\n");
+}
+
+static void sendHello() {
+  // Capacidades: o host escolhe codificação e taxa a partir daqui
+  Serial.printf("{\"evt\":\"hello\",\"proto\":%u,\"max_hz\":%d,"
+                "\"batch\":%d,\"ft\":%d,\"enc\":[\"bin\",\"json\"],\"pref\":\"bin\",\"fields\":[",
+                PROTO_VERSION, MAX_MESSAGE_HZ, BATCH_MAX, FT_BATCH_MAX);
+  for (int i = 0; i < FIELD_COUNT; i++) {
+    Serial.printf(i ? ",\"%s\"" : "\"%s\"", FIELDS[i].name);
+  }
+  Serial.print("]}\n");
+}
+
+static void runCommand(HostCommand cmd) {
+  switch (cmd) {
+    case CMD_STATS: sendLinkStats(); break;
+    case CMD_HELLO: sendHello();     break;
+    case CMD_PONG:  clockPong(stage.t0, stage.t1); break;
+    case CMD_PROF:  sendProfile();   break;
+    case CMD_SCHED: sendSchedule();  break;
+    default:        break;
+  }
+}
+
+void ingestTask(void* arg) {
+  // Anuncia no boot; um host já conectado negocia sem precisar perguntar
+  sendHello();
+
+  for (;;) {
+    readSerial();
+    updateLinkRates();
+    clockPing();
+    vTaskDelay(INGEST_POLL);
+  }
+}
+
+static void telemetryPublish(const HWData& d) {
+  // Escritor único (task de ingestão)
+  seqlockWrite(telemetry, d);
+
+  // Acorda o loop, que dorme até o próximo prazo de redraw
+  if (renderTaskHandle) xTaskNotifyGive(renderTaskHandle);
+}
+
+bool telemetryRead(HWData& out) {
+  // Leitor único (loop); retorna false se não há snapshot novo
+  return seqlockRead(telemetry, out, telemetrySeen);
+}
+
+static void samplePush(const HistorySample& smp) {
+  // Produtor único (ingestão); fila cheia descarta a amostra
+  uint32_t head = sampleHead.load(std::memory_order_relaxed);
+  if (head - sampleTail.load(std::memory_order_acquire) >= SAMPLE_QUEUE_LEN) {
+    linkStats.sampleDrops++;
+    return;
+  }
+  sampleQueue[head & (SAMPLE_QUEUE_LEN - 1)] = smp;
+  sampleHead.store(head + 1, std::memory_order_release);
+}
+
+void drainSamples() {
+  // Consumidor único (loop): move a fila para o histórico de cada métrica
+  uint32_t tail = sampleTail.load(std::memory_order_relaxed);
+  uint32_t head = sampleHead.load(std::memory_order_acquire);
+
+  for (; tail != head; tail++) {
+    const HistorySample& smp = sampleQueue[tail & (SAMPLE_QUEUE_LEN - 1)];
+    for (int m = 0; m < HIST_METRICS; m++) {
+      if (smp.mask & (1 << m)) historyPush(history[m], smp.v[m]);
+    }
+  }
+  sampleTail.store(tail, std::memory_order_release);
+}
+
+// ── Tempos de frame ─────────────────────────────────────────
+bool drainFrameTimes() {
+  // Consumidor único (loop); true quando chegou tempo novo
+  uint32_t tail = ftTail.load(std::memory_order_relaxed);
+  uint32_t head = ftHead.load(std::memory_order_acquire);
+  if (tail == head) return false;
+
+  unsigned long now = millis();
+  if (now - ftLastAt > FT_WINDOW_MS) {
+    // Sessão nova: as janelas antigas não dizem nada sobre ela
+    memset(ftHist, 0, sizeof(ftHist));
+    ftWindowAt = now;
+  } else if (now - ftWindowAt >= FT_WINDOW_MS) {
+    ftCur ^= 1;
+    memset(&ftHist[ftCur], 0, sizeof(FrameTimeHist));
+    ftWindowAt = now;
+  }
+  ftLastAt = now;
+
+  for (; tail != head; tail++) {
+    uint32_t us = ftQueue[tail & (FT_QUEUE_LEN - 1)] * 10u;
+    frameTimeAdd(ftHist[ftCur], us);
+    historyPush(ftHistory, (int16_t)min(us / 100, 32767u));  // 0,1 ms
+  }
+  ftTail.store(tail, std::memory_order_release);
+
+  frameStats = frameTimeStats(ftHist[0], ftHist[1]);
+  return true;
+}
 
-  delay(50);
+static bool frameTimesLive() {
+  return ftHistory.count > 0 && millis() - ftLastAt < FT_LIVE_MS;
 }
 
 // ============================================================
-// SERIAL + JSON
+// SERIAL — JSON + frames binários
 // ============================================================
 void readSerial() {
-  while (Serial.available()) {
-    char c = Serial.read();
-    if (c == '\n' || c == '\r') {
-      if (serialBuffer.length() > 0) {
-        parseJson(serialBuffer);
-        serialBuffer = "";
+  // Poll vazio não vira amostra do profiler
+  if (Serial.available() <= 0) return;
+  PROF_EVENT(PROF_RX);
+
+  // Frame que ficou aberto desde o último bloco: host caiu no meio
+  if (rxGapExpired(linkRx, millis())) linkStats.overflows++;
+
+  int avail;
+  while ((avail = Serial.available()) > 0) {
+    size_t n = Serial.readBytes(rxBuf, min((size_t)avail, RX_CHUNK_SIZE));
+    if (n == 0) break;
+    linkStats.rxBytes += n;
+    for (size_t i = 0; i < n; i++) {
+      parserFeed(rxBuf[i]);
+    }
+  }
+}
+
+static int* stageInt(const FieldDef& f) {
+  return fieldInt(hwStage, f);
+}
+
+static void requestKeyframe() {
+  if (millis() - lastKeyframeReq < KEYFRAME_REQ_INTERVAL) return;
+  lastKeyframeReq = millis();
+  linkStats.keyframeReqs++;
+  Serial.println("{\"evt\":\"keyframe\"}");
+}
+
+static void stageBegin() {
+  // Delta: parte do estado atual e só sobrescreve o que chegar
+  hwStage = hwIngest;
+  stage = StageMeta();
+}
+
+// Destino do parser JSON: o staging da ingestão
+struct StageSink {
+  void begin()                          { stageBegin(); }
+  void number(int field, int64_t v)     { applyNumber(hwStage, stage, field, v); }
+  void string(int field, const char* v) { applyString(hwStage, stage, field, v); }
+};
+
+StageSink stageSink;
+
+static void stageCommit() {
+  // Sem "seq" (host antigo) ou keyframe: mensagem completa
+  bool full = stage.keyframe || !stage.hasSeq;
+
+  if (!full && (!seqValid || stage.seq != (uint8_t)(lastSeq + 1))) {
+    if (seqValid) linkStats.seqGaps++;
+    linkStats.deltaDrops++;
+    seqValid = false;
+    requestKeyframe();
+    return;
+  }
+
+  if (full) {
+    // Campos numéricos ausentes valem 0; hora/data ausentes mantêm o valor atual
+    for (int i = 0; i < FIELD_COUNT; i++) {
+      if (FIELDS[i].type == FT_INT && !(stage.mask & (1 << i))) *stageInt(FIELDS[i]) = 0;
+    }
+  }
+
+  if (stage.hasSeq) {
+    lastSeq = stage.seq;
+    seqValid = true;
+  }
+
+  // Carimbo do host convertido para o nosso relógio
+  hwStage.sampledAt = 0;
+  if (stage.hasTs && hostClock.synced) {
+    hwStage.sampledAt = hostToLocal(stage.ts);
+    latencyAdd(latParse, hwStage.sampledAt);
+  }
+
+  hwIngest = hwStage;
+  telemetryPublish(hwIngest);
+
+  if (!stage.batched) {
+    // Uma amostra por mensagem quando o host não manda lote
+    HistorySample smp;
+    smp.mask = (1 << HIST_METRICS) - 1;
+    for (int m = 0; m < HIST_METRICS; m++) smp.v[m] = *stageInt(FIELDS[m]);
+    samplePush(smp);
+  }
+
+  unsigned long now = millis();
+  if (linkStats.messages > 0) linkStats.lastGapMs = now - lastMessageAt;
+  lastMessageAt = now;
+  linkStats.messages++;
+}
+
+static void parserReset() {
+  tp.state = PS_START;
+}
+
+static void parserEndLine() {
+  if (tp.state == PS_DONE) {
+    if (stage.cmd != CMD_NONE) runCommand(stage.cmd);
+    else                       stageCommit();
+  } else if (tp.state != PS_START) {
+    linkStats.jsonErrors++;
+  }
+  parserReset();
+}
+
+// ── Frames binários ─────────────────────────────────────────
+static void applyWire(int field, const uint8_t* q) {
+  // Valor de um campo no frame binário (FIELDS[field].wire bytes)
+  const FieldDef& f = FIELDS[field];
+
+  switch (f.type) {
+    case FT_INT: {
+      int v = (f.wire == 1) ? q[0] : readLE16(q);
+      *stageInt(f) = constrain(v, f.lo, f.hi);
+      break;
+    }
+    case FT_TIME:
+      if (q[0] < 24 && q[1] < 60) {
+        snprintf(hwStage.hora, sizeof(hwStage.hora), "%02u:%02u", q[0], q[1]);
       }
-    } else {
-      serialBuffer += c;
-      if (serialBuffer.length() > 512) {
-        serialBuffer = "";
+      break;
+    case FT_DATE:
+      if (q[1] >= 1 && q[1] <= 12) {
+        snprintf(hwStage.data, sizeof(hwStage.data), "%02u %s", q[0], MONTH_ABBR[q[1] - 1]);
       }
-    }
+      break;
+    default:
+      return;
   }
+  stage.mask |= 1 << field;
 }
 
-void parseJson(const String &json) {
-  StaticJsonDocument<384> doc;
-  DeserializationError err = deserializeJson(doc, json);
-  if (err) return;
+static void applyTelemetryFrame(const uint8_t* p, size_t len, bool keyframe) {
+  // seq (u8) | ts (u32) | máscara (u16) | campos presentes, na ordem
+  // de FIELDS | lote opcional de amostras (sample_batch.h)
+  if (len < 7) return;
+
+  stageBegin();
+  stage.hasSeq   = true;
+  stage.seq      = p[0];
+  stage.keyframe = keyframe;
+  stage.hasTs    = true;
+  stage.ts       = readLE32(p + 1);
+
+  uint16_t mask = readLE16(p + 5);
+  const uint8_t* q   = p + 7;
+  const uint8_t* end = p + len;
+
+  for (int i = 0; i < FIELD_COUNT; i++) {
+    if (!(mask & (1 << i))) continue;
+    if (q + FIELDS[i].wire > end) {  // frame truncado
+      linkStats.frameErrors++;
+      return;
+    }
+    applyWire(i, q);
+    q += FIELDS[i].wire;
+  }
+
+  if (q < end) {
+    // Lote inteiro validado antes: um frame ruim não deixa meio lote
+    // nos gráficos
+    SampleBatch batch;
+    if (!batchOpen(q, end, batch)) {
+      linkStats.frameErrors++;
+      return;
+    }
+    HistorySample smp;
+    for (uint8_t k = 0; k < batch.n; k++) {
+      batchSample(batch, k, smp);
+      samplePush(smp);
+    }
+    stage.batched = true;
+  }
+  stageCommit();
+}
 
-  hw.cpu      = constrain(doc["cpu"]      | 0, 0, 100);
-  hw.gpu      = constrain(doc["gpu"]      | 0, 0, 100);
-  hw.ram      = constrain(doc["ram"]      | 0, 0, 100);
-  hw.cpu_temp = constrain(doc["cpu_temp"] | 0, 0, 120);
-  hw.gpu_temp = constrain(doc["gpu_temp"] | 0, 0, 120);
-  hw.fps      = constrain(doc["fps"]      | 0, 0, 9999);
-  hw.cpu_clk  = constrain(doc["cpu_clk"]  | 0, 0, 9999);
-  hw.gpu_clk  = constrain(doc["gpu_clk"]  | 0, 0, 9999);
+static void applyFrameTimes(const uint8_t* p, size_t len) {
+  // n (u8) | n x tempo de frame (u16, unidades de 10 µs)
+  if (len < 1 || p[0] > FT_BATCH_MAX || len < 1 + 2 * (size_t)p[0]) {
+    linkStats.frameErrors++;
+    return;
+  }
+  uint32_t head = ftHead.load(std::memory_order_relaxed);
+  for (uint8_t k = 0; k < p[0]; k++) {
+    // Fila cheia descarta (o loop está travado; o histograma perde o frame)
+    if (head - ftTail.load(std::memory_order_acquire) >= FT_QUEUE_LEN) {
+      linkStats.sampleDrops++;
+      break;
+    }
+    ftQueue[head & (FT_QUEUE_LEN - 1)] = readLE16(p + 1 + 2 * k);
+    head++;
+  }
+  ftHead.store(head, std::memory_order_release);
+  if (renderTaskHandle) xTaskNotifyGive(renderTaskHandle);
+}
 
-  const char* t = doc["time"] | "";
-  if (strlen(t) > 0) {
-    strncpy(hw.hora, t, sizeof(hw.hora) - 1);
-    hw.hora[sizeof(hw.hora) - 1] = '\0';
+static void handleFrame(uint8_t* buf, size_t len) {
+  size_t n = cobsDecode(buf, len);
+  if (n < 4) {
+    linkStats.frameErrors++;
+    return;
+  }
+  if (crc16(buf, n - 2) != readLE16(buf + n - 2)) {
+    linkStats.crcErrors++;
+    return;
+  }
+  if (buf[0] != PROTO_VERSION) {
+    linkStats.frameErrors++;
+    return;
   }
 
-  const char* d = doc["date"] | "";
-  if (strlen(d) > 0) {
-    strncpy(hw.data, d, sizeof(hw.data) - 1);
-    hw.data[sizeof(hw.data) - 1] = '\0';
+  switch (buf[1]) {
+    case FRAME_KEYFRAME:
+    case FRAME_DELTA:
+      applyTelemetryFrame(buf + 2, n - 4, buf[1] == FRAME_KEYFRAME);
+      break;
+    case FRAME_FRAMETIMES:
+      applyFrameTimes(buf + 2, n - 4);
+      break;
+    default:
+      linkStats.frameErrors++;
+      break;
   }
+}
 
-  lastDataTime = millis();
-  hasSerialData = true;
+void parserFeed(char c) {
+  switch (rxPush(linkRx, (uint8_t)c)) {
+    case RX_CHAR:
+      parserStep(tp, stageSink, c);
+      break;
+    case RX_LINE_END:
+      parserEndLine();
+      break;
+    case RX_LINE_CUT:
+      // Um 0x00 sempre descarta a linha JSON parcial
+      if (tp.state != PS_START) linkStats.jsonErrors++;
+      parserReset();
+      break;
+    case RX_FRAME:
+      handleFrame(linkRx.frame, linkRx.frameLen);
+      break;
+    case RX_OVERFLOW:
+      linkStats.overflows++;
+      parserReset();
+      break;
+    default:
+      break;
+  }
 }
 
 // ============================================================
 // BOOT SCREEN
 // ============================================================
 void drawBootScreen(const char* msg) {
-  spr.fillSprite(COL_BG);
+  spr->fillSprite(COL_BG);
 
   int cx = SCREEN_W / 2;
-  spr.setTextColor(COL_CYAN);
-  spr.setTextSize(2);
-  spr.setTextDatum(MC_DATUM);
-  spr.drawString("HW MON", cx, 60);
+  spr->setTextColor(COL_CYAN);
+  spr->setTextSize(2);
+  spr->setTextDatum(MC_DATUM);
+  spr->drawString("HW MON", cx, 60);
 
-  spr.setTextColor(COL_DIM);
-  spr.setTextSize(1);
-  spr.drawString(msg, cx, 90);
+  spr->setTextColor(COL_DIM);
+  spr->setTextSize(1);
+  spr->drawString(msg, cx, 90);
 
-  spr.setTextDatum(TL_DATUM);
-  spr.pushSprite(0, 0);
+  spr->setTextDatum(TL_DATUM);
+  presentFrame();
 }
 
 // ============================================================
 // TELA CONFIG — Portal captive ativo, instrui o usuário
 // ============================================================
 void drawConfigScreen() {
-  spr.fillSprite(COL_BG);
+  spr->fillSprite(COL_BG);
 
   int cx = SCREEN_W / 2;
-  spr.setTextDatum(MC_DATUM);
+  spr->setTextDatum(MC_DATUM);
 
-  // Ícone WiFi piscando
-  uint8_t pulse = (millis() / 600) % 2;
-  spr.setTextColor(pulse ? COL_CYAN : COL_DIM);
-  spr.setTextSize(2);
-  spr.drawString("WiFi Setup", cx, 25);
+  // Ícone WiFi piscando (600 ms = 2 passos da bolinha)
+  uint8_t pulse = (millis() / (2 * CONFIG_DOT_MS)) % 2;
+  spr->setTextColor(pulse ? COL_CYAN : COL_DIM);
+  spr->setTextSize(2);
+  spr->drawString("WiFi Setup", cx, 25);
 
   // Instruções
-  spr.setTextColor(COL_TEXT);
-  spr.setTextSize(2);
-  spr.drawString("Conecte na rede:", cx, 58);
+  spr->setTextColor(COL_TEXT);
+  spr->setTextSize(2);
+  spr->drawString("Conecte na rede:", cx, 58);
 
-  spr.setTextColor(COL_YELLOW);
-  spr.setTextSize(3);
-  spr.drawString(AP_NAME, cx, 88);
+  spr->setTextColor(COL_YELLOW);
+  spr->setTextSize(3);
+  spr->drawString(AP_NAME, cx, 88);
 
-  spr.setTextColor(COL_DIM);
-  spr.setTextSize(1);
-  spr.drawString("Abra o navegador em 192.168.4.1", cx, 118);
-  spr.drawString("e selecione sua rede WiFi", cx, 132);
+  spr->setTextColor(COL_DIM);
+  spr->setTextSize(1);
+  spr->drawString("Abra o navegador em 192.168.4.1", cx, 118);
+  spr->drawString("e selecione sua rede WiFi", cx, 132);
 
   // Bolinha animada
-  int dotX = cx - 15 + ((millis() / 300) % 3) * 15;
-  spr.fillCircle(dotX, 152, 3, COL_CYAN);
+  int dotX = cx - 15 + ((millis() / CONFIG_DOT_MS) % 3) * 15;
+  spr->fillCircle(dotX, 152, 3, COL_CYAN);
+  scheduleFrameTick(CONFIG_DOT_MS);
 
-  spr.pushSprite(0, 0);
+  presentFrame();
+}
+
+// ============================================================
+// ATLAS DE GLIFOS — texto grande em poucos fillRect
+// ============================================================
+void buildGlyphAtlas() {
+#if GLYPH_ATLAS
+  // Rasteriza cada glifo uma vez numa célula 6x8 e lê de volta
+  TFT_eSprite cell(&tft);
+  if (!cell.createSprite(GLYPH_W, GLYPH_H)) return;
+  cell.setTextSize(1);
+  cell.setTextColor(TFT_WHITE);
+  cell.setTextDatum(TL_DATUM);
+
+  for (int g = 0; g < GLYPH_COUNT; g++) {
+    char str[2] = { GLYPH_CHARS[g], '\0' };
+    cell.fillSprite(TFT_BLACK);
+    cell.drawString(str, 0, 0);
+    glyphBuild(glyphAtlas[g], [&](int x, int y) { return cell.readPixel(x, y) != TFT_BLACK; });
+  }
+  cell.deleteSprite();
+#endif
+}
+
+void drawBigText(const char* text, int cx, int cy, int size, uint16_t color) {
+  // Equivale a drawString com fonte GLCD, textSize = size e MC_DATUM
+  PROF_SCOPE(PROF_GLYPH);
+  if (glyphDraw(*spr, glyphAtlas, text, cx, cy, size, color)) return;
+  spr->setTextColor(color);
+  spr->setTextSize(size);
+  spr->drawString(text, cx, cy);
+}
+
+// ============================================================
+// UI RETIDA — widgets ligados a dados, redesenho só onde mudou
+// ============================================================
+bool serialLinkActive() {
+  return (millis() - lastDataTime < SERIAL_TIMEOUT_MS) && hasSerialData;
+}
+
+static uint32_t setLabel(Widget& w, uint16_t color, const char* fmt, ...) {
+  // Formata o texto em cache; a chave é o hash do texto e da cor
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(w.text, sizeof(w.text), fmt, args);
+  va_end(args);
+  w.color = color;
+  return keyHashOf(w.text, FNV_BASIS ^ color);
+}
+
+static void paintLabel(const Widget& w) {
+  const LabelStyle& st = *w.label;
+  if (!w.text[0]) return;  // oculto
+  if (st.big) {
+    spr->setTextDatum(MC_DATUM);
+    drawBigText(w.text, st.ax, st.ay, st.size, w.color);
+    return;
+  }
+  spr->setTextDatum(st.datum);
+  spr->setTextColor(w.color);
+  spr->setTextSize(st.size);
+  spr->drawString(w.text, st.ax, st.ay);
+}
+
+static uint32_t bindOverlay(Widget& w) {
+  // Redesenha a cada OVERLAY_REFRESH_MS, não a cada frame
+  w.value = debugPage;
+  if (debugPage == DEBUG_OFF) return 0;
+  scheduleFrameTick(OVERLAY_REFRESH_MS);
+  return (millis() / OVERLAY_REFRESH_MS) * DEBUG_PAGES + debugPage;
+}
+
+static void paintOverlay(const Widget& w) {
+  if (w.value != DEBUG_OFF) drawDebugOverlay();
 }
 
 // ============================================================
 // TELA IDLE — Pixel art cat + relógio (funciona sem PC!)
 // ============================================================
+// ── Widgets da tela idle ──
+static const LabelStyle PA_LABEL      = { 45, 66, 3, MC_DATUM, false };
+static const LabelStyle CLOCK_LABEL   = { 225, 38, 4, MC_DATUM, true };
+static const LabelStyle DATE_LABEL    = { 225, 68, 2, MC_DATUM, false };
+static const LabelStyle WTEMP_LABEL   = { 223, 105, 2, ML_DATUM, false };
+static const LabelStyle WAGE_LABEL    = { 224, 114, 1, TL_DATUM, false };
+static const LabelStyle FOOT_L_LABEL  = { 8, SCREEN_H - 4, 1, BL_DATUM, false };
+static const LabelStyle FOOT_R_LABEL  = { SCREEN_W - 8, SCREEN_H - 4, 1, BR_DATUM, false };
+
+static uint32_t bindHeart(Widget& w) {
+  // Batida do coração: 0=normal, 1=grande, 2=normal, 3=pequeno
+  w.value = (millis() / IDLE_BEAT_MS) % 4;
+  scheduleFrameTick(IDLE_BEAT_MS);
+  return w.value;
+}
+
+static void paintHeart(const Widget& w) {
+  drawHeart(w.x + 1, w.y + 1, 4, w.value);
+}
+
+static uint32_t bindPa(Widget& w) {
+  return setLabel(w, COL_HEART_LT, "Pa");
+}
+
+static uint32_t bindIdleClock(Widget& w) {
+  return setLabel(w, COL_TEXT, "%s", hw.hora);
+}
+
+static uint32_t bindDate(Widget& w) {
+  return setLabel(w, COL_DIM, "%s", hw.data);
+}
+
+static bool weatherShown() {
+  // Clima velho segue valendo até WEATHER_MAX_AGE
+  return weatherValid && millis() - lastWeatherUpdate < WEATHER_MAX_AGE;
+}
+
+static uint32_t bindWeatherIcon(Widget& w) {
+  w.value = weatherShown() ? weatherCode : -1;
+  return w.value;
+}
+
+static void paintWeatherIcon(const Widget& w) {
+  if (w.value >= 0) drawWeatherIcon(w.x, w.y, 3, w.value);
+}
+
+static uint32_t bindWeatherTemp(Widget& w) {
+  if (!weatherShown()) return setLabel(w, COL_YELLOW, "");
+  return setLabel(w, COL_YELLOW, "%d%sC", weatherTemp, "\xB0");
+}
+
+static uint32_t bindWeatherAge(Widget& w) {
+  // Idade do clima: em destaque quando as buscas estão falhando
+  if (!weatherShown()) return setLabel(w, COL_DIM, "");
+  if (!weatherAgeKnown) return setLabel(w, COL_DIM, "cache");
+  unsigned long age = millis() - lastWeatherUpdate;
+  uint16_t color = age > WEATHER_STALE_MS ? COL_ORANGE : COL_DIM;
+  if (age < 60000) return setLabel(w, color, "agora");
+  if (age < 3600000UL) return setLabel(w, color, "ha %lu min", age / 60000);
+  return setLabel(w, color, "ha %lu h", age / 3600000UL);
+}
+
+static uint32_t bindLoadGraph(Widget& w) {
+  // Só com o PC conectado; cada amostra nova rola o gráfico
+  w.value = serialLinkActive();
+  return w.value ? history[FID_CPU].total + 1 : 0;
+}
+
+static void paintLoadGraph(const Widget& w) {
+  if (w.value) drawGraph(loadGraph);  // CPU/GPU %
+}
+
+static uint32_t bindFooterLeft(Widget& w) {
+  if (!serialLinkActive()) return setLabel(w, COL_DIM, "");
+  return setLabel(w, COL_DIM, "CPU %d%%  RAM %d%%", hw.cpu, hw.ram);
+}
+
+static uint32_t bindFooterRight(Widget& w) {
+  // Info do PC (se disponível) ou status WiFi
+  if (serialLinkActive()) {
+    if (hw.cpu_temp <= 0 && hw.gpu_temp <= 0) return setLabel(w, COL_DIM, "");
+    return setLabel(w, COL_DIM, "%d%sC / %d%sC", hw.cpu_temp, "\xB0", hw.gpu_temp, "\xB0");
+  }
+  if (wifiConnected) return setLabel(w, COL_DIM, "WiFi OK");
+  if (wifiConnecting) return setLabel(w, COL_DIM, "WiFi...");
+  return setLabel(w, COL_RED, "WiFi OFF");
+}
+
+#define LABEL_WIDGET(x, y, w, h, bind, style) { x, y, w, h, bind, paintLabel, &style, "", 0, 0, 0 }
+#define PAINT_WIDGET(x, y, w, h, bind, paint) { x, y, w, h, bind, paint, nullptr, "", 0, 0, 0 }
+
+Widget idleWidgets[] = {
+  PAINT_WIDGET(24, 17, 46, 38,   bindHeart,       paintHeart),
+  LABEL_WIDGET(24, 52, 42, 28,   bindPa,          PA_LABEL),
+  LABEL_WIDGET(164, 21, 122, 34, bindIdleClock,   CLOCK_LABEL),
+  LABEL_WIDGET(158, 60, 134, 16, bindDate,        DATE_LABEL),
+  PAINT_WIDGET(185, 93, 24, 24,  bindWeatherIcon, paintWeatherIcon),
+  LABEL_WIDGET(223, 97, 72, 16,  bindWeatherTemp, WTEMP_LABEL),
+  LABEL_WIDGET(224, 114, 66, 8,  bindWeatherAge,  WAGE_LABEL),
+  PAINT_WIDGET(0, LOAD_GRAPH_Y, GRAPH_W, LOAD_GRAPH_H, bindLoadGraph, paintLoadGraph),
+  LABEL_WIDGET(8, SCREEN_H - 12, 120, 8,               bindFooterLeft,  FOOT_L_LABEL),
+  LABEL_WIDGET(SCREEN_W - 98, SCREEN_H - 12, 90, 8,    bindFooterRight, FOOT_R_LABEL),
+  PAINT_WIDGET(4, 34, 168, 18 + PROF_COUNT * 10, bindOverlay, paintOverlay),
+};
+
 void drawIdleScreen() {
-  spr.fillSprite(COL_BG);
-
-  // Avança animação de batida do coração
-  if (millis() - idleAnimTimer > 600) {
-    idleAnimTimer = millis();
-    idleFrame = (idleFrame + 1) % 4;  // 0=normal, 1=grande, 2=normal, 3=pequeno
-  }
-
-  // ── Coração + "Pa" (esquerda) ──
-  int heartX = 25;
-  int heartY = 18;
-  int heartScale = 4;
-  drawHeart(heartX, heartY, heartScale, idleFrame);
-
-  // Nome "Pa" abaixo do coração
-  spr.setTextColor(COL_HEART_LT);
-  spr.setTextSize(3);
-  spr.setTextDatum(MC_DATUM);
-  spr.drawString("Pa", heartX + 5 * heartScale, heartY + 12 * heartScale);
-
-  // ── Relógio grande (direita) ──
-  int clockX = 225;
-
-  spr.setTextColor(COL_TEXT);
-  spr.setTextSize(4);
-  spr.setTextDatum(MC_DATUM);
-  spr.drawString(hw.hora, clockX, 38);
-
-  // Data abaixo
-  if (strlen(hw.data) > 0) {
-    spr.setTextColor(COL_DIM);
-    spr.setTextSize(2);
-    spr.drawString(hw.data, clockX, 68);
-  }
-
-  // ── Clima ──
-  if (weatherValid) {
-    int weatherY = 105;
-    // Ícone pixel art
-    drawWeatherIcon(clockX - 40, weatherY - 12, 3, weatherCode);
-
-    // Temperatura
-    char wBuf[12];
-    snprintf(wBuf, sizeof(wBuf), "%d%sC", weatherTemp, "\xB0");
-    spr.setTextColor(COL_YELLOW);
-    spr.setTextSize(2);
-    spr.setTextDatum(ML_DATUM);
-    spr.drawString(wBuf, clockX - 2, weatherY);
-  }
-
-  // ── Rodapé: info do PC (se disponível) ou status WiFi ──
-  bool serialActive = (millis() - lastDataTime < SERIAL_TIMEOUT_MS) && hasSerialData;
-
-  spr.setTextColor(COL_DIM);
-  spr.setTextSize(1);
-
-  if (serialActive) {
-    char infoBuf[32];
-    snprintf(infoBuf, sizeof(infoBuf), "CPU %d%%  RAM %d%%", hw.cpu, hw.ram);
-    spr.setTextDatum(BL_DATUM);
-    spr.drawString(infoBuf, 8, SCREEN_H - 4);
-
-    if (hw.cpu_temp > 0 || hw.gpu_temp > 0) {
-      char tempBuf[32];
-      snprintf(tempBuf, sizeof(tempBuf), "%d%sC / %d%sC",
-               hw.cpu_temp, "\xB0", hw.gpu_temp, "\xB0");
-      spr.setTextDatum(BR_DATUM);
-      spr.drawString(tempBuf, SCREEN_W - 8, SCREEN_H - 4);
-    }
-  } else {
-    // Sem serial: mostra status WiFi
-    spr.setTextDatum(BR_DATUM);
-    if (wifiConnected) {
-      spr.drawString("WiFi OK", SCREEN_W - 8, SCREEN_H - 4);
-    } else {
-      spr.setTextColor(COL_RED);
-      spr.drawString("WiFi OFF", SCREEN_W - 8, SCREEN_H - 4);
+  renderScreen(idleWidgets, sizeof(idleWidgets) / sizeof(idleWidgets[0]));
+}
+
+// ============================================================
+// PIXEL ART — grades constexpr assadas em retângulos
+// ============================================================
+// Cada desenho é uma grade de caracteres: '.' vazio, '1'..'9' cor na
+// paleta do desenho. Em compilação a grade vira uma lista de
+// retângulos (faixas horizontais empilhadas), desenhada com um
+// fillRect por retângulo. Novo ícone = nova grade.
+static const int ART_MAX_RUNS = 24;
+
+struct PixelRun { uint8_t x, y, w, h, color; };  // em células; color 1..9
+
+struct PixelArt {
+  bool     ok;
+  uint8_t  n;
+  PixelRun r[ART_MAX_RUNS];
+};
+
+// baseUnder: a cor 1 cobre todas as células e as demais cores são
+// pintadas por cima, na ordem do índice. Com pixels que se sobrepõem
+// (coração expandido) isso reproduz a ordem de pintura original.
+static constexpr PixelArt bakeArt(const char* const* rows, int h, bool baseUnder) {
+  PixelArt art{};
+  art.ok = true;
+  for (char c = '1'; c <= '9'; c++) {
+    for (int y = 0; y < h; y++) {
+      for (int x = 0; rows[y][x]; ) {
+        char cell = rows[y][x];
+        bool hit = (baseUnder && c == '1') ? cell != '.' : cell == c;
+        if (!hit) { x++; continue; }
+
+        int x0 = x;
+        while (rows[y][x]) {
+          char k = rows[y][x];
+          if (!((baseUnder && c == '1') ? k != '.' : k == c)) break;
+          x++;
+        }
+
+        // Mesma faixa e cor na linha de cima: estica o retângulo
+        int r = 0;
+        while (r < art.n && !(art.r[r].color == c - '0' && art.r[r].x == x0 &&
+                              art.r[r].w == x - x0 && art.r[r].y + art.r[r].h == y)) r++;
+        if (r < art.n) {
+          art.r[r].h++;
+        } else if (art.n < ART_MAX_RUNS) {
+          art.r[art.n++] = PixelRun{ (uint8_t)x0, (uint8_t)y, (uint8_t)(x - x0), 1,
+                                     (uint8_t)(c - '0') };
+        } else {
+          art.ok = false;
+        }
+      }
     }
   }
+  return art;
+}
 
-  spr.pushSprite(0, 0);
+static void drawArt(const PixelArt& art, const uint16_t* pal, int ox, int oy,
+                    int s, int es, int adj) {
+  // es >= s: células vizinhas se encostam (ou sobrepõem), então a
+  // faixa inteira vira um retângulo sem mudar o resultado
+  for (int i = 0; i < art.n; i++) {
+    const PixelRun& r = art.r[i];
+    spr->fillRect(ox + r.x * s + adj, oy + r.y * s + adj,
+                  (r.w - 1) * s + es, (r.h - 1) * s + es, pal[r.color - 1]);
+  }
 }
 
 // ============================================================
 // CORAÇÃO PIXEL ART — com animação de batida
-// Grid: 11 wide x 10 tall
+// Grid: 11 wide x 9 tall
 // Frames: 0,2=normal  1=expand  3=shrink
 // ============================================================
+static constexpr const char* HEART_ROWS[] = {
+  ".111...111.",   // topos dos dois "bumps"
+  "11221111111",   // 2 = brilho (canto superior esquerdo)
+  "12211111111",
+  "11111111131",   // 3 = sombra (borda inferior direita)
+  ".111111133.",
+  "..1111133..",   // afunilando
+  "...11133...",
+  "....133....",
+  ".....1.....",
+};
+static const int HEART_H = sizeof(HEART_ROWS) / sizeof(HEART_ROWS[0]);
+static constexpr PixelArt HEART_ART = bakeArt(HEART_ROWS, HEART_H, true);
+static_assert(HEART_ART.ok, "coração não cabe em ART_MAX_RUNS");
+static const uint16_t HEART_PAL[] = { COL_HEART, COL_HEART_LT, COL_HEART_DK };
+
 void drawHeart(int ox, int oy, int s, int frame) {
+  PROF_SCOPE(PROF_ART);
   // Offset para animação de batida
   int expand = 0;
   if (frame == 1) expand = 1;       // batida: cresce
@@ -515,203 +2282,663 @@ void drawHeart(int ox, int oy, int s, int frame) {
   int es = s + expand; // tamanho efetivo do pixel (não menor que s-1)
   if (es < s - 1) es = s - 1;
 
-  #define HP(x, y, col) spr.fillRect(ox + (x)*s + adj, oy + (y)*s + adj, es, es, col)
-
-  // Linha 0: topos dos dois "bumps"
-  //    ##  ##
-  HP(1,0,COL_HEART); HP(2,0,COL_HEART); HP(3,0,COL_HEART);
-  HP(7,0,COL_HEART); HP(8,0,COL_HEART); HP(9,0,COL_HEART);
-
-  // Linha 1: expande
-  // #######.####
-  for (int x = 0; x <= 10; x++) HP(x, 1, COL_HEART);
-
-  // Linha 2-4: cheio
-  for (int x = 0; x <= 10; x++) HP(x, 2, COL_HEART);
-  for (int x = 0; x <= 10; x++) HP(x, 3, COL_HEART);
-  for (int x = 1; x <= 9; x++)  HP(x, 4, COL_HEART);
-
-  // Linha 5-8: afunilando
-  for (int x = 2; x <= 8; x++) HP(x, 5, COL_HEART);
-  for (int x = 3; x <= 7; x++) HP(x, 6, COL_HEART);
-  for (int x = 4; x <= 6; x++) HP(x, 7, COL_HEART);
-  HP(5, 8, COL_HEART);
-
-  // Brilho (canto superior esquerdo)
-  HP(2, 1, COL_HEART_LT); HP(3, 1, COL_HEART_LT);
-  HP(1, 2, COL_HEART_LT); HP(2, 2, COL_HEART_LT);
-
-  // Sombra (borda inferior direita)
-  HP(9, 3, COL_HEART_DK);
-  HP(8, 4, COL_HEART_DK); HP(9, 4, COL_HEART_DK);
-  HP(7, 5, COL_HEART_DK); HP(8, 5, COL_HEART_DK);
-  HP(6, 6, COL_HEART_DK); HP(7, 6, COL_HEART_DK);
-  HP(5, 7, COL_HEART_DK); HP(6, 7, COL_HEART_DK);
+  if (es >= s) {
+    drawArt(HEART_ART, HEART_PAL, ox, oy, s, es, adj);
+    return;
+  }
 
-  #undef HP
+  // Contraído: pixels menores que a célula deixam uma fresta entre
+  // eles, então cada célula é desenhada sozinha para manter o visual
+  for (int y = 0; y < HEART_H; y++) {
+    for (int x = 0; HEART_ROWS[y][x]; x++) {
+      char c = HEART_ROWS[y][x];
+      if (c == '.') continue;
+      spr->fillRect(ox + x * s + adj, oy + y * s + adj, es, es, HEART_PAL[c - '1']);
+    }
+  }
 }
 
 // ============================================================
-// ÍCONE CLIMA — pixel art procedural (WMO weather codes)
+// ÍCONE CLIMA — pixel art (WMO weather codes), grades 8x8
 // ============================================================
-void drawWeatherIcon(int ox, int oy, int s, int code) {
-  #define WP(x, y, col) spr.fillRect(ox + (x)*s, oy + (y)*s, s, s, col)
+static constexpr const char* SUN_ROWS[] = {
+  "...11...",
+  ".1....1.",
+  "...11...",
+  "1.1111.1",
+  "1.1111.1",
+  "...11...",
+  ".1....1.",
+  "...11...",
+};
+static constexpr const char* PARTLY_ROWS[] = {   // 1 = sol, 2 = nuvem
+  ".....111",
+  "....111.",
+  "........",
+  "..2222..",
+  ".222222.",
+  ".222222.",
+};
+static constexpr const char* OVERCAST_ROWS[] = {
+  "........",
+  "..1111..",
+  ".111111.",
+  ".111111.",
+  "11111111",
+  "11111111",
+};
+static constexpr const char* RAIN_ROWS[] = {     // 1 = nuvem, 2 = gotas
+  "..1111..",
+  ".111111.",
+  "11111111",
+  "........",
+  ".2.2.2..",
+  "..2.2.2.",
+  ".2.2.2..",
+};
+static constexpr const char* SNOW_ROWS[] = {     // 1 = nuvem, 2 = flocos
+  "..1111..",
+  ".111111.",
+  "11111111",
+  "........",
+  "..2..2..",
+  ".2..2..2",
+  "...2..2.",
+};
+static constexpr const char* STORM_ROWS[] = {    // 1 = nuvem, 2 = raio, 3 = gotas
+  "..1111..",
+  ".111111.",
+  "11111111",
+  "....2...",
+  ".3.222..",
+  "...22.3.",
+  "..2.....",
+};
+static constexpr const char* CLOUD_ROWS[] = {    // fallback: nuvem genérica
+  "........",
+  "..1111..",
+  ".111111.",
+  "11111111",
+  "11111111",
+};
+
+#define BAKE_ICON(rows) bakeArt(rows, sizeof(rows) / sizeof(rows[0]), false)
+static constexpr PixelArt SUN_ART      = BAKE_ICON(SUN_ROWS);
+static constexpr PixelArt PARTLY_ART   = BAKE_ICON(PARTLY_ROWS);
+static constexpr PixelArt OVERCAST_ART = BAKE_ICON(OVERCAST_ROWS);
+static constexpr PixelArt RAIN_ART     = BAKE_ICON(RAIN_ROWS);
+static constexpr PixelArt SNOW_ART     = BAKE_ICON(SNOW_ROWS);
+static constexpr PixelArt STORM_ART    = BAKE_ICON(STORM_ROWS);
+static constexpr PixelArt CLOUD_ART    = BAKE_ICON(CLOUD_ROWS);
+#undef BAKE_ICON
+static_assert(SUN_ART.ok && PARTLY_ART.ok && OVERCAST_ART.ok && RAIN_ART.ok &&
+              SNOW_ART.ok && STORM_ART.ok && CLOUD_ART.ok,
+              "ícone de clima não cabe em ART_MAX_RUNS");
 
+void drawWeatherIcon(int ox, int oy, int s, int code) {
+  PROF_SCOPE(PROF_ART);
   if (code <= 1) {
     // ── Sol ──
-    uint16_t SUN = COL_YELLOW;
-    // Centro
-    WP(3,2,SUN); WP(4,2,SUN);
-    WP(2,3,SUN); WP(3,3,SUN); WP(4,3,SUN); WP(5,3,SUN);
-    WP(2,4,SUN); WP(3,4,SUN); WP(4,4,SUN); WP(5,4,SUN);
-    WP(3,5,SUN); WP(4,5,SUN);
-    // Raios
-    WP(3,0,SUN); WP(4,0,SUN);
-    WP(0,3,SUN); WP(7,3,SUN);
-    WP(0,4,SUN); WP(7,4,SUN);
-    WP(3,7,SUN); WP(4,7,SUN);
-    WP(1,1,SUN); WP(6,1,SUN);
-    WP(1,6,SUN); WP(6,6,SUN);
-
+    static const uint16_t pal[] = { COL_YELLOW };
+    drawArt(SUN_ART, pal, ox, oy, s, s, 0);
   } else if (code == 2) {
     // ── Sol + nuvem ──
-    uint16_t SUN = COL_YELLOW;
-    uint16_t CLD = COL_DIM;
-    // Sol pequeno (canto superior direito)
-    WP(5,0,SUN); WP(6,0,SUN);
-    WP(5,1,SUN); WP(6,1,SUN);
-    WP(7,0,SUN); WP(4,1,SUN);
-    // Nuvem na frente
-    WP(2,3,CLD); WP(3,3,CLD); WP(4,3,CLD); WP(5,3,CLD);
-    WP(1,4,CLD); WP(2,4,CLD); WP(3,4,CLD); WP(4,4,CLD); WP(5,4,CLD); WP(6,4,CLD);
-    WP(1,5,CLD); WP(2,5,CLD); WP(3,5,CLD); WP(4,5,CLD); WP(5,5,CLD); WP(6,5,CLD);
-
+    static const uint16_t pal[] = { COL_YELLOW, COL_DIM };
+    drawArt(PARTLY_ART, pal, ox, oy, s, s, 0);
   } else if (code == 3 || (code >= 45 && code <= 48)) {
     // ── Nublado / neblina ──
-    uint16_t CLD = COL_DIM;
-    WP(2,1,CLD); WP(3,1,CLD); WP(4,1,CLD); WP(5,1,CLD);
-    WP(1,2,CLD); WP(2,2,CLD); WP(3,2,CLD); WP(4,2,CLD); WP(5,2,CLD); WP(6,2,CLD);
-    WP(1,3,CLD); WP(2,3,CLD); WP(3,3,CLD); WP(4,3,CLD); WP(5,3,CLD); WP(6,3,CLD);
-    WP(0,4,CLD); WP(1,4,CLD); WP(2,4,CLD); WP(3,4,CLD); WP(4,4,CLD); WP(5,4,CLD); WP(6,4,CLD); WP(7,4,CLD);
-    WP(0,5,CLD); WP(1,5,CLD); WP(2,5,CLD); WP(3,5,CLD); WP(4,5,CLD); WP(5,5,CLD); WP(6,5,CLD); WP(7,5,CLD);
-
+    static const uint16_t pal[] = { COL_DIM };
+    drawArt(OVERCAST_ART, pal, ox, oy, s, s, 0);
   } else if ((code >= 51 && code <= 67) || (code >= 80 && code <= 82)) {
     // ── Chuva ──
-    uint16_t CLD = COL_DIM;
-    uint16_t DRP = COL_CYAN;
-    // Nuvem
-    WP(2,0,CLD); WP(3,0,CLD); WP(4,0,CLD); WP(5,0,CLD);
-    WP(1,1,CLD); WP(2,1,CLD); WP(3,1,CLD); WP(4,1,CLD); WP(5,1,CLD); WP(6,1,CLD);
-    WP(0,2,CLD); WP(1,2,CLD); WP(2,2,CLD); WP(3,2,CLD); WP(4,2,CLD); WP(5,2,CLD); WP(6,2,CLD); WP(7,2,CLD);
-    // Gotas
-    WP(1,4,DRP); WP(3,4,DRP); WP(5,4,DRP);
-    WP(2,5,DRP); WP(4,5,DRP); WP(6,5,DRP);
-    WP(1,6,DRP); WP(3,6,DRP); WP(5,6,DRP);
-
+    static const uint16_t pal[] = { COL_DIM, COL_CYAN };
+    drawArt(RAIN_ART, pal, ox, oy, s, s, 0);
   } else if (code >= 71 && code <= 77) {
     // ── Neve ──
-    uint16_t CLD = COL_DIM;
-    uint16_t SNW = COL_TEXT;
-    // Nuvem
-    WP(2,0,CLD); WP(3,0,CLD); WP(4,0,CLD); WP(5,0,CLD);
-    WP(1,1,CLD); WP(2,1,CLD); WP(3,1,CLD); WP(4,1,CLD); WP(5,1,CLD); WP(6,1,CLD);
-    WP(0,2,CLD); WP(1,2,CLD); WP(2,2,CLD); WP(3,2,CLD); WP(4,2,CLD); WP(5,2,CLD); WP(6,2,CLD); WP(7,2,CLD);
-    // Flocos
-    WP(2,4,SNW); WP(5,4,SNW);
-    WP(1,5,SNW); WP(4,5,SNW); WP(7,5,SNW);
-    WP(3,6,SNW); WP(6,6,SNW);
-
+    static const uint16_t pal[] = { COL_DIM, COL_TEXT };
+    drawArt(SNOW_ART, pal, ox, oy, s, s, 0);
   } else if (code >= 95) {
     // ── Trovoada ──
-    uint16_t CLD = COL_DIM;
-    uint16_t ZAP = COL_YELLOW;
-    uint16_t DRP = COL_CYAN;
-    // Nuvem
-    WP(2,0,CLD); WP(3,0,CLD); WP(4,0,CLD); WP(5,0,CLD);
-    WP(1,1,CLD); WP(2,1,CLD); WP(3,1,CLD); WP(4,1,CLD); WP(5,1,CLD); WP(6,1,CLD);
-    WP(0,2,CLD); WP(1,2,CLD); WP(2,2,CLD); WP(3,2,CLD); WP(4,2,CLD); WP(5,2,CLD); WP(6,2,CLD); WP(7,2,CLD);
-    // Raio
-    WP(4,3,ZAP); WP(3,4,ZAP); WP(4,4,ZAP); WP(5,4,ZAP);
-    WP(3,5,ZAP); WP(4,5,ZAP); WP(2,6,ZAP);
-    // Gotas
-    WP(1,4,DRP); WP(6,5,DRP);
-
+    static const uint16_t pal[] = { COL_DIM, COL_YELLOW, COL_CYAN };
+    drawArt(STORM_ART, pal, ox, oy, s, s, 0);
   } else {
     // Fallback: nuvem genérica
-    uint16_t CLD = COL_DIM;
-    WP(2,1,CLD); WP(3,1,CLD); WP(4,1,CLD); WP(5,1,CLD);
-    WP(1,2,CLD); WP(2,2,CLD); WP(3,2,CLD); WP(4,2,CLD); WP(5,2,CLD); WP(6,2,CLD);
-    WP(0,3,CLD); WP(1,3,CLD); WP(2,3,CLD); WP(3,3,CLD); WP(4,3,CLD); WP(5,3,CLD); WP(6,3,CLD); WP(7,3,CLD);
-    WP(0,4,CLD); WP(1,4,CLD); WP(2,4,CLD); WP(3,4,CLD); WP(4,4,CLD); WP(5,4,CLD); WP(6,4,CLD); WP(7,4,CLD);
+    static const uint16_t pal[] = { COL_DIM };
+    drawArt(CLOUD_ART, pal, ox, oy, s, s, 0);
   }
-
-  #undef WP
 }
 
 // ============================================================
 // TELA GAMING — FPS grande + temps
 // ============================================================
+// ── Widgets da tela gaming ──
+static const LabelStyle GAME_CLOCK_LABEL = { SCREEN_W - 28, 8, 2, TR_DATUM, false };
+static const LabelStyle FPS_LABEL        = { SCREEN_W / 2, 78, 7, MC_DATUM, true };
+static const LabelStyle FPS_UNIT_LABEL   = { SCREEN_W / 2, 113, 2, MC_DATUM, false };
+static const LabelStyle AVG_LABEL        = { SCREEN_W - 6, 36, 1, TR_DATUM, false };
+static const LabelStyle LOW1_LABEL       = { SCREEN_W - 6, 46, 1, TR_DATUM, false };
+static const LabelStyle LOW01_LABEL      = { SCREEN_W - 6, 56, 1, TR_DATUM, false };
+static const LabelStyle CPU_TEMP_LABEL   = { 10, SCREEN_H - 20, 2, BL_DATUM, false };
+static const LabelStyle GPU_TEMP_LABEL   = { SCREEN_W - 10, SCREEN_H - 20, 2, BR_DATUM, false };
+
+static uint32_t bindStatic(Widget& w) {
+  return 1;
+}
+
+static void paintGamingChrome(const Widget& w) {
+  spr->drawFastHLine(0, 0, SCREEN_W, COL_DIM);
+  spr->setTextSize(2);
+  spr->setTextDatum(TL_DATUM);
+  spr->setTextColor(COL_ORANGE);
+  spr->drawString("GAMING", 8, 8);
+  spr->drawFastHLine(0, 30, SCREEN_W, COL_DIM);
+}
+
+static uint32_t bindGamingClock(Widget& w) {
+  return setLabel(w, COL_TEXT, "%s", hw.hora);
+}
+
+static uint32_t bindPulse(Widget& w) {
+  w.value = (millis() / GAMING_PULSE_MS) % 2;
+  scheduleFrameTick(GAMING_PULSE_MS);
+  return w.value;
+}
+
+static void paintPulse(const Widget& w) {
+  spr->fillCircle(SCREEN_W - 10, 15, 5, w.value ? COL_GREEN : COL_GREEN_DK);
+}
+
+static uint32_t bindBigGraph(Widget& w) {
+  // Tempos de frame quando o host manda (mostram os engasgos), senão
+  // o FPS. Trocar de fonte muda a chave e redesenha o gráfico inteiro
+  bool ftLive = frameTimesLive();
+  Graph& big = ftLive ? ftGraph : fpsGraph;
+  static Graph* lastBig = nullptr;
+  if (&big != lastBig) {
+    big.seen = 0;  // o buffer é compartilhado: redesenha tudo
+    lastBig = &big;
+  }
+  w.value = ftLive;
+  return big.s[0].src->total ^ (ftLive ? 0x80000000u : 0);
+}
+
+static void paintBigGraph(const Widget& w) {
+  drawGraph(w.value ? ftGraph : fpsGraph);
+}
+
+static uint32_t bindTempGraph(Widget& w) {
+  return history[FID_CPU_TEMP].total;
+}
+
+static void paintTempGraph(const Widget& w) {
+  drawGraph(tempGraph);
+}
+
+static uint32_t bindFps(Widget& w) {
+  if (hw.fps <= 0) return setLabel(w, COL_YELLOW, "");
+  return setLabel(w, COL_YELLOW, "%d", hw.fps);
+}
+
+static uint32_t bindFpsUnit(Widget& w) {
+  return setLabel(w, COL_DIM, hw.fps > 0 ? "FPS" : "");
+}
+
+// FPS médio e lows (últimos 10–20 s)
+static uint32_t bindAvg(Widget& w) {
+  if (!frameTimesLive()) return setLabel(w, COL_TEXT, "");
+  return setLabel(w, COL_TEXT, "avg %u", frameStats.avg);
+}
+
+static uint32_t bindLow1(Widget& w) {
+  if (!frameTimesLive()) return setLabel(w, COL_ORANGE, "");
+  return setLabel(w, COL_ORANGE, "1%% %u", frameStats.low1);
+}
+
+static uint32_t bindLow01(Widget& w) {
+  if (!frameTimesLive()) return setLabel(w, COL_ORANGE, "");
+  return setLabel(w, COL_ORANGE, ".1%% %u", frameStats.low01);
+}
+
+static uint32_t bindCpuTemp(Widget& w) {
+  return setLabel(w, COL_CYAN, "CPU %d%sC", hw.cpu_temp, "\xB0");
+}
+
+static uint32_t bindGpuTemp(Widget& w) {
+  return setLabel(w, COL_MAGENTA, "GPU %d%sC", hw.gpu_temp, "\xB0");
+}
+
+static uint32_t bindScanlines(Widget& w) {
+  // Scanline quando temp > 80
+  if (max(hw.cpu_temp, hw.gpu_temp) <= 80) {
+    w.value = -1;
+    return 0;
+  }
+  scanlineOffset = (millis() / SCANLINE_STEP_MS) % 4;
+  scheduleFrameTick(SCANLINE_STEP_MS);
+  w.value = scanlineOffset;
+  return w.value + 1;
+}
+
+static void paintScanlines(const Widget& w) {
+  if (w.value < 0) return;
+  for (int y = w.value; y < SCREEN_H; y += 4) {
+    spr->drawFastHLine(0, y, SCREEN_W, COL_SCANLINE);
+  }
+}
+
+Widget gamingWidgets[] = {
+  PAINT_WIDGET(0, 0, SCREEN_W, 31,            bindStatic,      paintGamingChrome),
+  LABEL_WIDGET(SCREEN_W - 90, 8, 62, 16,      bindGamingClock, GAME_CLOCK_LABEL),
+  PAINT_WIDGET(SCREEN_W - 16, 9, 12, 12,      bindPulse,       paintPulse),
+  PAINT_WIDGET(0, FPS_GRAPH_Y, GRAPH_W, FPS_GRAPH_H,   bindBigGraph,  paintBigGraph),
+  PAINT_WIDGET(0, TEMP_GRAPH_Y, GRAPH_W, TEMP_GRAPH_H, bindTempGraph, paintTempGraph),
+  LABEL_WIDGET(74, 50, 172, 58,               bindFps,         FPS_LABEL),
+  LABEL_WIDGET(140, 104, 40, 18,              bindFpsUnit,     FPS_UNIT_LABEL),
+  LABEL_WIDGET(SCREEN_W - 66, 36, 60, 8,      bindAvg,         AVG_LABEL),
+  LABEL_WIDGET(SCREEN_W - 66, 46, 60, 8,      bindLow1,        LOW1_LABEL),
+  LABEL_WIDGET(SCREEN_W - 66, 56, 60, 8,      bindLow01,       LOW01_LABEL),
+  LABEL_WIDGET(10, SCREEN_H - 36, 120, 16,    bindCpuTemp,     CPU_TEMP_LABEL),
+  LABEL_WIDGET(SCREEN_W - 130, SCREEN_H - 36, 120, 16, bindGpuTemp, GPU_TEMP_LABEL),
+  PAINT_WIDGET(0, 0, SCREEN_W, SCREEN_H,      bindScanlines,   paintScanlines),
+  PAINT_WIDGET(4, 34, 168, 18 + PROF_COUNT * 10, bindOverlay, paintOverlay),
+};
+
+#undef LABEL_WIDGET
+#undef PAINT_WIDGET
+
 void drawGamingScreen() {
-  spr.fillSprite(COL_BG);
+  renderScreen(gamingWidgets, sizeof(gamingWidgets) / sizeof(gamingWidgets[0]));
+}
 
-  // ── Header ──
-  spr.drawFastHLine(0, 0, SCREEN_W, COL_DIM);
+// ============================================================
+// GRÁFICOS — histórico rolando sem redesenhar os pontos antigos
+// ============================================================
+static void graphBlit(const Graph& g) {
+  // Desfaz o buffer circular linha a linha direto no sprite. Escreve
+  // na memória, então respeita o clip da UI à mão (x sempre par)
+  int x0 = max((int)g.x, (int)uiClip.x0), x1 = min(g.x + g.w, (int)uiClip.x1);
+  int y0 = max((int)g.y, (int)uiClip.y0), y1 = min(g.y + g.h, (int)uiClip.y1);
+  if (x0 >= x1 || y0 >= y1) return;
+
+  uint8_t line[GRAPH_W];
+  for (int y = y0; y < y1; y++) {
+    graphRow(g, y - g.y, line);
+#if FRAME_PALETTE
+    uint8_t* dst = (uint8_t*)spr->getPointer() + y * (SCREEN_W / 2) + x0 / 2;
+    for (int i = x0 - g.x; i < x1 - g.x; i += 2) *dst++ = (line[i] << 4) | line[i + 1];
+#else
+    uint16_t* dst = (uint16_t*)spr->getPointer() + y * SCREEN_W + x0;
+    for (int i = x0 - g.x; i < x1 - g.x; i++) *dst++ = paletteWire[line[i]];
+#endif
+  }
+}
 
-  spr.setTextSize(2);
-  spr.setTextDatum(TL_DATUM);
-  spr.setTextColor(COL_ORANGE);
-  spr.drawString("GAMING", 8, 8);
+void drawGraph(Graph& g) {
+  PROF_SCOPE(PROF_GRAPH);
+  if (g.s[0].src->count == 0) return;
+  graphUpdate(g);
+  graphBlit(g);
+}
 
-  spr.setTextColor(COL_TEXT);
-  spr.setTextDatum(TR_DATUM);
-  spr.drawString(hw.hora, SCREEN_W - 28, 8);
+// ============================================================
+// PUSH PARCIAL — só os retângulos que mudaram
+// ============================================================
+bool createFrameSprite(TFT_eSprite& frame) {
+#if FRAME_PALETTE
+  // 4bpp: 27 KB por buffer, cabe (em dobro) na SRAM interna
+  frame.setColorDepth(4);
+  frame.setAttribute(PSRAM_ENABLE, false);
+#endif
+  if (!frame.createSprite(SCREEN_W, SCREEN_H)) return false;
+#if FRAME_PALETTE
+  frame.createPalette(PALETTE_RGB565, 16);
+#endif
+  frame.setTextDatum(TL_DATUM);
+  return true;
+}
 
-  uint8_t pulse = (millis() / 500) % 2;
-  spr.fillCircle(SCREEN_W - 10, 15, 5, pulse ? COL_GREEN : 0x03E0);
+static void hashTiles(bool dirty[TILES_Y][TILES_X], int& count, const TileMask* only) {
+  // FNV por palavra de 32 bits; linhas e tiles são alinhados em palavras.
+  // Com only, tiles fora da máscara não mudaram e nem são lidos
+  const uint32_t* buf = (const uint32_t*)spr->getPointer();
+  const int wordsPerRow  = SCREEN_W * FRAME_BPP / 32;
+  const int wordsPerTile = TILE_W * FRAME_BPP / 32;
+  count = 0;
+
+  for (int ty = 0; ty < TILES_Y; ty++) {
+    uint32_t h[TILES_X];
+    for (int tx = 0; tx < TILES_X; tx++) h[tx] = FNV_BASIS;
+
+    int yEnd = min(SCREEN_H, (ty + 1) * TILE_H);
+    for (int y = ty * TILE_H; y < yEnd; y++) {
+      const uint32_t* row = buf + y * wordsPerRow;
+      for (int tx = 0; tx < TILES_X; tx++) {
+        if (only && !(*only)[ty][tx]) continue;
+        const uint32_t* w = row + tx * wordsPerTile;
+        uint32_t acc = h[tx];
+        for (int i = 0; i < wordsPerTile; i++) acc = (acc ^ w[i]) * FNV_PRIME;
+        h[tx] = acc;
+      }
+    }
 
-  spr.drawFastHLine(0, 30, SCREEN_W, COL_DIM);
+    for (int tx = 0; tx < TILES_X; tx++) {
+      if (only && !(*only)[ty][tx]) {
+        dirty[ty][tx] = false;
+        continue;
+      }
+      dirty[ty][tx] = fullRedraw || h[tx] != tileHash[ty][tx];
+      tileHash[ty][tx] = h[tx];
+      if (dirty[ty][tx]) count++;
+    }
+  }
+}
 
-  // ── FPS gigante ──
-  int cx = SCREEN_W / 2;
+static int buildRects(bool dirty[TILES_Y][TILES_X], DirtyRect* rects) {
+  // Junta tiles sujos em faixas horizontais e empilha faixas
+  // iguais de linhas consecutivas no mesmo retângulo
+  int n = 0;
+  for (int ty = 0; ty < TILES_Y; ty++) {
+    for (int tx = 0; tx < TILES_X; ) {
+      if (!dirty[ty][tx]) { tx++; continue; }
+      int x0 = tx;
+      while (tx < TILES_X && dirty[ty][tx]) tx++;
+
+      int r = 0;
+      while (r < n && !(rects[r].x0 == x0 && rects[r].x1 == tx && rects[r].y1 == ty)) r++;
+      if (r < n) rects[r].y1 = ty + 1;
+      else       rects[n++] = DirtyRect{ (uint8_t)x0, (uint8_t)tx, (uint8_t)ty, (uint8_t)(ty + 1) };
+    }
+  }
+  return n;
+}
+
+#if FRAME_PALETTE
+// Pares de pixels (um byte 4bpp) já em RGB565 na ordem do barramento
+uint32_t palettePairs[256];
+uint16_t pushStrip[SCREEN_W * TILE_H];  // uma faixa de tiles expandida
+#endif
+
+void buildPaletteTables() {
+  for (int i = 0; i < 16; i++) paletteWire[i] = (PALETTE_RGB565[i] >> 8) | (PALETTE_RGB565[i] << 8);
+#if FRAME_PALETTE
+  // Nibble alto = pixel da esquerda (formato do TFT_eSprite 4bpp)
+  for (int b = 0; b < 256; b++) {
+    palettePairs[b] = paletteWire[b >> 4] | ((uint32_t)paletteWire[b & 0x0F] << 16);
+  }
+#endif
+}
+
+#if FRAME_PALETTE
+
+static void pushIndexed(TFT_eSprite* src, int x, int y, int w, int h) {
+  // Expande a paleta faixa a faixa; x e w são múltiplos de TILE_W (pares)
+  const uint8_t* buf = (const uint8_t*)src->getPointer();
+  const int bytesPerRow = SCREEN_W / 2;
+
+  for (int y0 = y; y0 < y + h; y0 += TILE_H) {
+    int rows = min(TILE_H, y + h - y0);
+    uint32_t* out = (uint32_t*)pushStrip;
+    for (int yy = y0; yy < y0 + rows; yy++) {
+      const uint8_t* p = buf + yy * bytesPerRow + x / 2;
+      for (int i = 0; i < w / 2; i++) *out++ = palettePairs[p[i]];
+    }
+    tft.pushImage(x, y0, w, rows, pushStrip);
+  }
+}
+#endif
+
+static void pushRect(TFT_eSprite* src, int x, int y, int w, int h) {
+#if FRAME_PALETTE
+  pushIndexed(src, x, y, w, h);
+#else
+  if (x == 0 && y == 0 && w == SCREEN_W && h == SCREEN_H) src->pushSprite(0, 0);
+  else src->pushSprite(x, y, x, y, w, h);
+#endif
+}
 
-  if (hw.fps > 0) {
-    char fpsBuf[8];
-    snprintf(fpsBuf, sizeof(fpsBuf), "%d", hw.fps);
-    spr.setTextColor(COL_YELLOW);
-    spr.setTextSize(7);
-    spr.setTextDatum(MC_DATUM);
-    spr.drawString(fpsBuf, cx, 78);
-
-    spr.setTextColor(COL_DIM);
-    spr.setTextSize(2);
-    spr.drawString("FPS", cx, 113);
-  }
-
-  // ── Temps embaixo ──
-  char tempBuf[16];
-  int tempY = SCREEN_H - 20;
-
-  spr.setTextColor(COL_CYAN);
-  spr.setTextSize(2);
-  spr.setTextDatum(BL_DATUM);
-  snprintf(tempBuf, sizeof(tempBuf), "CPU %d%sC", hw.cpu_temp, "\xB0");
-  spr.drawString(tempBuf, 10, tempY);
-
-  spr.setTextColor(COL_MAGENTA);
-  spr.setTextDatum(BR_DATUM);
-  snprintf(tempBuf, sizeof(tempBuf), "GPU %d%sC", hw.gpu_temp, "\xB0");
-  spr.drawString(tempBuf, SCREEN_W - 10, tempY);
-
-  // ── Scanline quando temp > 80 ──
-  int maxTemp = max(hw.cpu_temp, hw.gpu_temp);
-  if (maxTemp > 80) {
-    scanlineOffset = (scanlineOffset + 1) % 4;
-    for (int y = scanlineOffset; y < SCREEN_H; y += 4) {
-      spr.drawFastHLine(0, y, SCREEN_W, COL_SCANLINE);
+static void runPush(const FramePush& job) {
+  PROF_EVENT(PROF_PUSH);
+  uint32_t t0 = micros();
+  if (job.full) {
+    // Quase tudo mudou: um bloco só evita o setWindow por linha
+    pushRect(job.src, 0, 0, SCREEN_W, SCREEN_H);
+  } else {
+    for (int r = 0; r < job.n; r++) {
+      int x = job.rects[r].x0 * TILE_W;
+      int y = job.rects[r].y0 * TILE_H;
+      int w = (job.rects[r].x1 - job.rects[r].x0) * TILE_W;
+      int h = min(SCREEN_H, job.rects[r].y1 * TILE_H) - y;
+      pushRect(job.src, x, y, w, h);
     }
   }
+  pushUs = micros() - t0;
+  if (job.sampledAt) latencyAdd(latPush, job.sampledAt);
+}
+
+void pushTask(void* arg) {
+  for (;;) {
+    xSemaphoreTake(pushStart, portMAX_DELAY);
+    runPush(framePush);
+    xSemaphoreGive(pushDone);
+  }
+}
 
-  spr.pushSprite(0, 0);
+void presentFrame(const TileMask* damage) {
+  // Sem máscara de dano o frame foi desenhado inteiro (telas imediatas)
+  renderUs = micros() - frameStartUs;
+  profRenderDone();
+  if (!damage) uiScreen = nullptr;
+
+  bool dirty[TILES_Y][TILES_X];
+  int count;
+  FramePush job;
+  {
+    PROF_SCOPE(PROF_HASH);
+    hashTiles(dirty, count, damage);
+    job.full = count >= FULL_PUSH_TILES;
+    job.n    = job.full ? 0 : buildRects(dirty, job.rects);
+  }
+  job.src  = spr;
+  job.sampledAt = hw.sampledAt;
+  hw.sampledAt = 0;
+
+  fullRedraw  = false;
+  pushedTiles = count;
+  pushedRects = job.full ? 1 : job.n;
+
+  if (asyncPush) {
+    // Fence: o push anterior termina antes de reusarmos o job e o
+    // buffer dele, que é onde o próximo frame vai ser desenhado
+    uint32_t t0 = micros();
+    {
+      PROF_SCOPE(PROF_FENCE);
+      xSemaphoreTake(pushDone, portMAX_DELAY);
+    }
+    fenceUs = micros() - t0;
+
+    framePush = job;
+    xSemaphoreGive(pushStart);
+    spr = (spr == &frames[0]) ? &frames[1] : &frames[0];
+  } else {
+    runPush(job);
+  }
+  profEndFrame();
+}
+
+static void damageWidget(const Widget& w, TileMask& damage) {
+  int tx1 = min(TILES_X, (w.x + w.w + TILE_W - 1) / TILE_W);
+  int ty1 = min(TILES_Y, (w.y + w.h + TILE_H - 1) / TILE_H);
+  for (int ty = max(0, w.y / TILE_H); ty < ty1; ty++) {
+    for (int tx = max(0, w.x / TILE_W); tx < tx1; tx++) damage[ty][tx] = true;
+  }
+}
+
+void renderScreen(Widget* ws, int n) {
+  // Tela nova (ou o sprite foi desenhado por uma tela imediata):
+  // tudo danificado; senão só os tiles de widgets cuja chave mudou
+  bool all = fullRedraw || ws != uiScreen;
+  TileMask damage;
+  memset(damage, all, sizeof(damage));
+  for (int i = 0; i < n; i++) {
+    uint32_t key = ws[i].bind(ws[i]);
+    if (key != ws[i].key || all) damageWidget(ws[i], damage);
+    ws[i].key = key;
+  }
+
+  // Com push assíncrono o sprite atual tem o frame de dois frames
+  // atrás: o dano do frame anterior também precisa ser refeito nele
+  TileMask stale;
+  for (int ty = 0; ty < TILES_Y; ty++) {
+    for (int tx = 0; tx < TILES_X; tx++) {
+      stale[ty][tx] = damage[ty][tx] || (asyncPush && !all && uiPrevDamage[ty][tx]);
+    }
+  }
+  memcpy(uiPrevDamage, damage, sizeof(damage));
+  uiScreen = ws;
+
+  // Limpa e repinta cada retângulo com clip nele, na ordem da lista
+  DirtyRect rects[TILES_X * TILES_Y / 2 + 1];
+  int nr = buildRects(stale, rects);
+  for (int r = 0; r < nr; r++) {
+    PixelRect c = { (int16_t)(rects[r].x0 * TILE_W), (int16_t)(rects[r].y0 * TILE_H),
+                    (int16_t)(rects[r].x1 * TILE_W),
+                    (int16_t)min(SCREEN_H, rects[r].y1 * TILE_H) };
+    uiClip = c;
+    spr->setViewport(c.x0, c.y0, c.x1 - c.x0, c.y1 - c.y0, false);
+    {
+      PROF_SCOPE(PROF_CLEAR);
+      spr->fillRect(c.x0, c.y0, c.x1 - c.x0, c.y1 - c.y0, COL_BG);
+    }
+    for (int i = 0; i < n; i++) {
+      const Widget& w = ws[i];
+      if (w.x < c.x1 && w.x + w.w > c.x0 && w.y < c.y1 && w.y + w.h > c.y0) w.paint(w);
+    }
+  }
+  spr->resetViewport();
+  uiClip = PixelRect{ 0, 0, SCREEN_W, SCREEN_H };
+
+  presentFrame(&damage);
+}
+
+// ============================================================
+// OVERLAY DE DEBUG — saúde do link serial
+// ============================================================
+void drawDebugOverlay() {
+  PROF_SCOPE(PROF_OVERLAY);
+  if (debugPage == DEBUG_PROF) {
+    drawProfileOverlay();
+    return;
+  }
+  if (debugPage == DEBUG_SCHED) {
+    drawScheduleOverlay();
+    return;
+  }
+
+  const int bx = 4, by = 34, bw = 168, bh = 86;
+  spr->fillRect(bx, by, bw, bh, COL_BG);
+  spr->drawRect(bx, by, bw, bh, COL_DIM);
+
+  spr->setTextSize(1);
+  spr->setTextDatum(TL_DATUM);
+  spr->setTextColor(COL_GREEN);
+
+  char line[40];
+  int y = by + 4;
+  snprintf(line, sizeof(line), "RX %lu B/s  %lu msg/s",
+           (unsigned long)linkStats.bytesPerSec, (unsigned long)linkStats.msgsPerSec);
+  spr->drawString(line, bx + 4, y);
+  y += 10;
+  snprintf(line, sizeof(line), "dt %lu ms  kf req %lu",
+           (unsigned long)linkStats.lastGapMs, (unsigned long)linkStats.keyframeReqs);
+  spr->drawString(line, bx + 4, y);
+  y += 10;
+  snprintf(line, sizeof(line), "err json %lu frm %lu crc %lu",
+           (unsigned long)linkStats.jsonErrors, (unsigned long)linkStats.frameErrors,
+           (unsigned long)linkStats.crcErrors);
+  spr->drawString(line, bx + 4, y);
+  y += 10;
+  snprintf(line, sizeof(line), "ovf %lu  gap %lu  drop %lu",
+           (unsigned long)linkStats.overflows, (unsigned long)linkStats.seqGaps,
+           (unsigned long)linkStats.deltaDrops);
+  spr->drawString(line, bx + 4, y);
+  y += 10;
+
+  // Latência: p50/p95/p99 em ms desde a amostragem no host
+  LatencyPct lp = latencyPercentiles(latParse);
+  LatencyPct ls = latencyPercentiles(latPush);
+  spr->setTextColor(hostClock.synced ? COL_CYAN : COL_DIM);
+  snprintf(line, sizeof(line), "rx  %u/%u/%u ms", lp.p50, lp.p95, lp.p99);
+  spr->drawString(line, bx + 4, y);
+  y += 10;
+  snprintf(line, sizeof(line), "lcd %u/%u/%u ms  rtt %lu",
+           ls.p50, ls.p95, ls.p99, (unsigned long)hostClock.rtt);
+  spr->drawString(line, bx + 4, y);
+  y += 10;
+
+  // Push parcial do frame anterior
+  spr->setTextColor(COL_DIM);
+  snprintf(line, sizeof(line), "tiles %u/%d  rects %u",
+           pushedTiles, TILES_X * TILES_Y, pushedRects);
+  spr->drawString(line, bx + 4, y);
+  y += 10;
+  snprintf(line, sizeof(line), "us draw %lu push %lu f %lu",
+           (unsigned long)renderUs, (unsigned long)pushUs, (unsigned long)fenceUs);
+  spr->drawString(line, bx + 4, y);
+}
+
+void drawProfileOverlay() {
+  // min/méd/p99 (µs) das últimas PROF_SAMPLES amostras de cada estágio
+  const int bx = 4, by = 34, bw = 168, bh = 18 + PROF_COUNT * 10;
+  spr->fillRect(bx, by, bw, bh, COL_BG);
+  spr->drawRect(bx, by, bw, bh, COL_DIM);
+
+  spr->setTextSize(1);
+  spr->setTextDatum(TL_DATUM);
+  spr->setTextColor(COL_DIM);
+
+  char line[40];
+  int y = by + 4;
+  snprintf(line, sizeof(line), "%-7s%6s%6s%6s", "us", "min", "avg", "p99");
+  spr->drawString(line, bx + 4, y);
+  y += 10;
+
+  spr->setTextColor(COL_GREEN);
+  for (int i = 0; i < PROF_COUNT; i++) {
+    ProfStat st = profStat((ProfStage)i);
+    snprintf(line, sizeof(line), "%-7s%6lu%6lu%6lu", PROF_NAMES[i],
+             (unsigned long)st.min, (unsigned long)st.avg, (unsigned long)st.p99);
+    spr->drawString(line, bx + 4, y);
+    y += 10;
+  }
+}
+
+void drawScheduleOverlay() {
+  // Atraso p50/p99 (ms) em relação ao prazo, pior execução (µs) e
+  // execuções acima do orçamento de cada tarefa do loop
+  const int bx = 4, by = 34, bw = 168, bh = 18 + SCHED_COUNT * 10;
+  spr->fillRect(bx, by, bw, bh, COL_BG);
+  spr->drawRect(bx, by, bw, bh, COL_DIM);
+
+  spr->setTextSize(1);
+  spr->setTextDatum(TL_DATUM);
+  spr->setTextColor(COL_DIM);
+
+  char line[40];
+  int y = by + 4;
+  snprintf(line, sizeof(line), "%-7s%4s%4s%7s%4s", "ms", "p50", "p99", "max us", "ovr");
+  spr->drawString(line, bx + 4, y);
+  y += 10;
+
+  for (int i = 0; i < SCHED_COUNT; i++) {
+    const SchedTask& t = sched[i];
+    LatencyPct lp = latencyPercentiles(t.late);
+    spr->setTextColor(t.overruns ? COL_ORANGE : COL_GREEN);
+    snprintf(line, sizeof(line), "%-7s%4u%4u%7lu%4lu", SCHED_DEFS[i].name, lp.p50, lp.p99,
+             (unsigned long)min(t.maxUs, (uint32_t)999999),
+             (unsigned long)min(t.overruns, (uint32_t)999));
+    spr->drawString(line, bx + 4, y);
+    y += 10;
+  }
 }
 
 // ============================================================
@@ -0,0 +1,75 @@
+// ============================================================
+// Profiler — anel de amostras por estágio e min/méd/p99
+// Cada estágio acumula ticks dos seus escopos e fecha uma amostra
+// por frame ou por chamada; as últimas PROF_SAMPLES dão min/méd/p99
+// em µs. No ESP32 os ticks são ciclos do core; nativo (testes de
+// firmware/test) são ns do std::chrono.
+// ============================================================
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+static const int PROF_SAMPLES = 64;
+
+struct ProfRing {
+  uint32_t acc;              // ticks do frame/chamada em andamento
+  bool     ran;              // algum escopo do estágio rodou
+  uint32_t v[PROF_SAMPLES];  // ticks
+  volatile uint16_t head;
+  volatile uint16_t count;
+};
+
+struct ProfStat { uint32_t min, avg, p99; };  // µs
+
+#ifdef ARDUINO
+static inline uint32_t profNow()        { return ESP.getCycleCount(); }
+static inline uint32_t profTicksPerUs() { return ESP.getCpuFreqMHz(); }
+#else
+static inline uint32_t profNow() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static inline uint32_t profTicksPerUs() { return 1000; }
+#endif
+
+static inline void profRingCommit(ProfRing& r) {
+  // Escritor único por anel (loop, push ou ingestão)
+  if (!r.ran) return;  // estágio não rodou (tela sem arte, overlay desligado)
+  r.v[r.head] = r.acc;
+  r.head = (r.head + 1) % PROF_SAMPLES;
+  if (r.count < PROF_SAMPLES) r.count++;
+  r.acc = 0;
+  r.ran = false;
+}
+
+static inline ProfStat profRingStat(const ProfRing& r, uint32_t ticksPerUs) {
+  uint32_t v[PROF_SAMPLES];
+  int n = r.count;
+  if (n == 0) return ProfStat{0, 0, 0};
+  memcpy(v, r.v, sizeof(v));
+  std::sort(v, v + n);
+
+  uint64_t sum = 0;
+  for (int i = 0; i < n; i++) sum += v[i];
+  return ProfStat{ v[0] / ticksPerUs, (uint32_t)(sum / n / ticksPerUs), v[n * 99 / 100] / ticksPerUs };
+}
+
+struct ProfScope {
+  // Soma a duração do escopo no anel; commit fecha uma amostra na saída
+  ProfRing& r;
+  bool      commit;
+  uint32_t  t0;
+  ProfScope(ProfRing& ring, bool c) : r(ring), commit(c), t0(profNow()) {}
+  ~ProfScope() {
+    r.acc += profNow() - t0;
+    r.ran = true;
+    if (commit) profRingCommit(r);
+  }
+};
@@ -0,0 +1,70 @@
+// ============================================================
+// Lote de amostras — histórico sub-segundo nos frames binários
+// Layout do lote que o monitor.py anexa ao frame de telemetria e a
+// validação dele. Não depende do Arduino: compila nativo (g++) para
+// os testes de firmware/test.
+// ============================================================
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "telemetry.h"
+
+static const int HIST_METRICS = 6;   // FIELDS[0..5]: cpu..fps
+static const int BATCH_MAX    = 24;  // amostras por frame (anunciado)
+
+struct HistorySample {
+  uint8_t mask;      // métricas presentes (bit = índice em FIELDS)
+  int16_t v[HIST_METRICS];
+};
+
+static inline uint16_t readLE16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t readLE32(const uint8_t* p) {
+  return readLE16(p) | ((uint32_t)readLE16(p + 2) << 16);
+}
+
+// n (u8) | máscara (u16, só métricas do histórico) | n x [idade ms (u16),
+// valores presentes na ordem de FIELDS]. A idade (quanto antes do envio)
+// só ordena as amostras: o gráfico tem uma coluna por amostra.
+struct SampleBatch {
+  const uint8_t* rec;      // primeiro registro
+  uint8_t        n;
+  uint16_t       mask;
+  uint8_t        recSize;  // idade + valores
+};
+
+static inline uint8_t batchRecordSize(uint16_t mask) {
+  uint8_t size = 2;
+  for (int m = 0; m < HIST_METRICS; m++) {
+    if (mask & (1 << m)) size += FIELDS[m].wire;
+  }
+  return size;
+}
+
+static inline bool batchOpen(const uint8_t* q, const uint8_t* end, SampleBatch& b) {
+  // Valida o lote inteiro antes de qualquer amostra sair: n dentro do
+  // limite e n registros ocupando exatamente o resto do payload
+  if (end - q < 3) return false;
+  b.n       = q[0];
+  b.mask    = readLE16(q + 1) & ((1 << HIST_METRICS) - 1);
+  b.rec     = q + 3;
+  b.recSize = batchRecordSize(b.mask);
+  return b.n <= BATCH_MAX && (size_t)(end - b.rec) == (size_t)b.n * b.recSize;
+}
+
+static inline void batchSample(const SampleBatch& b, uint8_t k, HistorySample& smp) {
+  // Amostra k de um lote já validado por batchOpen
+  const uint8_t* q = b.rec + (size_t)k * b.recSize + 2;  // pula a idade
+  smp.mask = (uint8_t)b.mask;
+  for (int m = 0; m < HIST_METRICS; m++) {
+    smp.v[m] = 0;
+    if (!(b.mask & (1 << m))) continue;
+    const FieldDef& f = FIELDS[m];
+    int v = (f.wire == 1) ? q[0] : readLE16(q);
+    smp.v[m] = v < f.lo ? f.lo : v > f.hi ? f.hi : v;
+    q += f.wire;
+  }
+}
@@ -0,0 +1,55 @@
+// ============================================================
+// Seqlock — um escritor, um leitor, sem lock
+// A versão fica ímpar durante a escrita; o leitor copia e só aceita
+// a cópia se a versão era par e não mudou. Os dados são palavras
+// atômicas (relaxed), então a cópia concorrente não é data race.
+// Só depende de <atomic>: compila nativo para os testes com threads.
+// ============================================================
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+template <class T>
+struct Seqlock {
+  static_assert(std::is_trivially_copyable<T>::value, "seqlock copia T como bytes");
+  static const size_t WORDS = (sizeof(T) + 3) / 4;
+
+  std::atomic<uint32_t> version{0};  // ímpar = escrita em andamento
+  std::atomic<uint32_t> words[WORDS] = {};
+};
+
+template <class T>
+static void seqlockWrite(Seqlock<T>& s, const T& d) {
+  // Escritor único
+  uint32_t w[Seqlock<T>::WORDS] = {};
+  memcpy(w, &d, sizeof(T));
+
+  uint32_t v = s.version.load(std::memory_order_relaxed);
+  s.version.store(v + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < Seqlock<T>::WORDS; i++) s.words[i].store(w[i], std::memory_order_relaxed);
+  s.version.store(v + 2, std::memory_order_release);
+}
+
+template <class T>
+static bool seqlockRead(const Seqlock<T>& s, T& out, uint32_t& seen) {
+  // Leitor único; false se não há versão nova desde seen
+  uint32_t w[Seqlock<T>::WORDS];
+  for (;;) {
+    uint32_t v1 = s.version.load(std::memory_order_acquire);
+    if (v1 == seen) return false;
+    if (v1 & 1) continue;  // escrita em andamento no outro core
+
+    for (size_t i = 0; i < Seqlock<T>::WORDS; i++) w[i] = s.words[i].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s.version.load(std::memory_order_relaxed) == v1) {
+      memcpy(&out, w, sizeof(T));
+      seen = v1;
+      return true;
+    }
+  }
+}
@@ -0,0 +1,386 @@
+// ============================================================
+// Telemetria — campos, hash das chaves e parser JSON streaming
+// A tabela FIELDS, o hash perfeito das chaves e o parser byte a
+// byte não dependem do Arduino: compilam nativo (g++) para os
+// testes e benchmarks de firmware/test.
+// ============================================================
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// ── Dados recebidos ─────────────────────────────────────────
+struct HWData {
+  int cpu      = 0;
+  int gpu      = 0;
+  int ram      = 0;
+  int cpu_temp = 0;
+  int gpu_temp = 0;
+  int fps      = 0;
+  int cpu_clk  = 0;
+  int gpu_clk  = 0;
+  char hora[6]  = "--:--";
+  char data[12] = "";
+  uint32_t sampledAt = 0;  // millis() em que o host amostrou (0 = sem carimbo)
+};
+
+// ── Campos de telemetria ────────────────────────────────────
+// Tabela única: nome da chave JSON, onde gravar em HWData, faixa e
+// tamanho no frame binário. O índice é também o bit na máscara do
+// frame. Para um campo novo basta acrescentar uma linha aqui.
+enum FieldId : uint8_t {
+  FID_CPU, FID_GPU, FID_RAM, FID_CPU_TEMP, FID_GPU_TEMP,
+  FID_FPS, FID_CPU_CLK, FID_GPU_CLK, FID_TIME, FID_DATE,
+  FIELD_COUNT,                   // campos de HWData (bits da máscara)
+  FID_SEQ = FIELD_COUNT, FID_KF, FID_TS,  // metadados da mensagem
+  FID_CMD, FID_T0, FID_T1,       // comando do host e argumentos do pong
+  FIELD_DEF_COUNT,
+};
+
+enum FieldType : uint8_t {
+  FT_INT, FT_TIME, FT_DATE, FT_SEQ, FT_KEYFRAME, FT_STAMP, FT_CMD, FT_PONG_T0, FT_PONG_T1,
+};
+
+struct FieldDef {
+  const char* name;
+  FieldType   type;
+  uint16_t    offset;  // offsetof(HWData, ...)
+  int16_t     lo, hi;
+  uint8_t     wire;    // bytes no frame binário
+};
+
+static constexpr FieldDef FIELDS[FIELD_DEF_COUNT] = {
+  { "cpu",      FT_INT,      offsetof(HWData, cpu),      0, 100,  1 },
+  { "gpu",      FT_INT,      offsetof(HWData, gpu),      0, 100,  1 },
+  { "ram",      FT_INT,      offsetof(HWData, ram),      0, 100,  1 },
+  { "cpu_temp", FT_INT,      offsetof(HWData, cpu_temp), 0, 120,  1 },
+  { "gpu_temp", FT_INT,      offsetof(HWData, gpu_temp), 0, 120,  1 },
+  { "fps",      FT_INT,      offsetof(HWData, fps),      0, 9999, 2 },
+  { "cpu_clk",  FT_INT,      offsetof(HWData, cpu_clk),  0, 9999, 2 },
+  { "gpu_clk",  FT_INT,      offsetof(HWData, gpu_clk),  0, 9999, 2 },
+  { "time",     FT_TIME,     offsetof(HWData, hora),     0, 0,    2 },
+  { "date",     FT_DATE,     offsetof(HWData, data),     0, 0,    2 },
+  { "seq",      FT_SEQ,      0,                          0, 255,  0 },
+  { "kf",       FT_KEYFRAME, 0,                          0, 1,    0 },
+  { "ts",       FT_STAMP,    0,                          0, 0,    0 },
+  { "cmd",      FT_CMD,      0,                          0, 0,    0 },
+  { "t0",       FT_PONG_T0,  0,                          0, 0,    0 },
+  { "t1",       FT_PONG_T1,  0,                          0, 0,    0 },
+};
+
+// ── Hash perfeito das chaves (gerado em compilação) ─────────
+// FNV-1a com semente escolhida em constexpr para que cada chave
+// caia num slot próprio. O parser calcula o hash enquanto lê a
+// chave; um slot só casa se hash e tamanho baterem.
+static const uint32_t KEY_SLOTS = 64;
+static const uint32_t FNV_BASIS = 2166136261u;
+static const uint32_t FNV_PRIME = 16777619u;
+
+static constexpr uint32_t keyHashStep(uint32_t h, char c) {
+  return (h ^ (uint8_t)c) * FNV_PRIME;
+}
+
+static constexpr uint32_t keyHashOf(const char* s, uint32_t seed) {
+  uint32_t h = seed;
+  while (*s) h = keyHashStep(h, *s++);
+  return h;
+}
+
+static constexpr uint8_t keyLenOf(const char* s) {
+  uint8_t n = 0;
+  while (s[n]) n++;
+  return n;
+}
+
+struct KeyTable {
+  bool     found;
+  uint32_t seed;
+  int8_t   field[KEY_SLOTS];
+  uint32_t hash[KEY_SLOTS];
+  uint8_t  len[KEY_SLOTS];
+};
+
+static constexpr KeyTable buildKeyTable() {
+  for (uint32_t k = 0; k < 10000; k++) {
+    KeyTable t{};
+    t.seed = FNV_BASIS ^ (k * 0x9E3779B9u);
+    for (uint32_t i = 0; i < KEY_SLOTS; i++) t.field[i] = -1;
+
+    bool ok = true;
+    for (int i = 0; i < FIELD_DEF_COUNT && ok; i++) {
+      uint32_t h = keyHashOf(FIELDS[i].name, t.seed);
+      uint32_t slot = h & (KEY_SLOTS - 1);
+      if (t.field[slot] >= 0) {
+        ok = false;
+      } else {
+        t.field[slot] = i;
+        t.hash[slot]  = h;
+        t.len[slot]   = keyLenOf(FIELDS[i].name);
+      }
+    }
+    if (ok) {
+      t.found = true;
+      return t;
+    }
+  }
+  return KeyTable{};
+}
+
+static constexpr KeyTable KEYS = buildKeyTable();
+static_assert(KEYS.found, "sem hash perfeito para FIELDS: aumente KEY_SLOTS");
+
+// Comandos do host: {"cmd":"stats"}, {"cmd":"hello"}, {"cmd":"prof"},
+// {"cmd":"sched"}, {"cmd":"pong","t0":...,"t1":...}
+enum HostCommand : uint8_t { CMD_NONE, CMD_STATS, CMD_HELLO, CMD_PONG, CMD_PROF, CMD_SCHED };
+
+struct StageMeta {
+  uint16_t mask = 0;
+  bool     hasSeq = false;
+  uint8_t  seq = 0;
+  bool     keyframe = false;
+  bool     batched = false;  // histórico já veio no lote do frame
+  bool     hasTs = false;
+  uint32_t ts = 0;           // instante da amostra no relógio do host (ms)
+  HostCommand cmd = CMD_NONE;
+  uint32_t t0 = 0, t1 = 0;   // pong: nosso millis() do ping, relógio do host
+};
+
+static inline int lookupKey(uint32_t h, uint8_t len) {
+  uint32_t slot = h & (KEY_SLOTS - 1);
+  int f = KEYS.field[slot];
+  return (f >= 0 && KEYS.hash[slot] == h && KEYS.len[slot] == len) ? f : -1;
+}
+
+// ── Staging ─────────────────────────────────────────────────
+// Grava um valor já decodificado no HWData de staging (campos de
+// HWData, com a faixa de FIELDS) ou nos metadados da mensagem.
+static inline int* fieldInt(HWData& d, const FieldDef& f) {
+  return (int*)((uint8_t*)&d + f.offset);
+}
+
+static inline char* fieldStr(HWData& d, const FieldDef& f) {
+  return (char*)((uint8_t*)&d + f.offset);
+}
+
+static inline int clampField(int64_t v, const FieldDef& f) {
+  return (int)(v < f.lo ? f.lo : v > f.hi ? f.hi : v);
+}
+
+static inline void applyNumber(HWData& d, StageMeta& st, int field, int64_t v) {
+  if (field < 0) return;
+  const FieldDef& f = FIELDS[field];
+
+  switch (f.type) {
+    case FT_INT:
+      *fieldInt(d, f) = clampField(v, f);
+      st.mask |= 1 << field;
+      break;
+    case FT_SEQ:
+      st.hasSeq = true;
+      st.seq = (uint8_t)v;
+      break;
+    case FT_KEYFRAME:
+      st.keyframe = (v != 0);
+      break;
+    case FT_STAMP:
+      st.hasTs = true;
+      st.ts = (uint32_t)v;
+      break;
+    case FT_PONG_T0:
+      st.t0 = (uint32_t)v;
+      break;
+    case FT_PONG_T1:
+      st.t1 = (uint32_t)v;
+      break;
+    default:
+      break;
+  }
+}
+
+static inline void applyString(HWData& d, StageMeta& st, int field, const char* v) {
+  if (field < 0 || v[0] == '\0') return;
+  const FieldDef& f = FIELDS[field];
+
+  if (f.type == FT_CMD) {
+    if      (!strcmp(v, "stats")) st.cmd = CMD_STATS;
+    else if (!strcmp(v, "hello")) st.cmd = CMD_HELLO;
+    else if (!strcmp(v, "pong"))  st.cmd = CMD_PONG;
+    else if (!strcmp(v, "prof"))  st.cmd = CMD_PROF;
+    else if (!strcmp(v, "sched")) st.cmd = CMD_SCHED;
+    return;
+  }
+  if (f.type != FT_TIME && f.type != FT_DATE) return;
+
+  size_t cap = (f.type == FT_TIME) ? sizeof(d.hora) : sizeof(d.data);
+  size_t n = strnlen(v, cap - 1);  // trunca como o strncpy, sem aviso do -Wstringop
+  memcpy(fieldStr(d, f), v, n);
+  fieldStr(d, f)[n] = '\0';
+  st.mask |= 1 << field;
+}
+
+// ── Parser de telemetria (streaming) ────────────────────────
+// Consome o JSON byte a byte conforme chega e entrega os campos
+// conhecidos ao destino (Sink): begin() no '{', number()/string()
+// a cada valor. Quem chama aplica a linha só se o '\n' chegar com
+// o objeto fechado (PS_DONE).
+enum ParseState : uint8_t {
+  PS_START,    // espera '{'
+  PS_KEY,      // espera '"' da chave ou '}'
+  PS_KEY_STR,  // dentro da chave
+  PS_COLON,    // espera ':'
+  PS_VALUE,    // espera início do valor
+  PS_NUMBER,
+  PS_STRING,
+  PS_LITERAL,  // true / false / null (ignorados)
+  PS_NESTED,   // objeto ou array aninhado (ignorado)
+  PS_NEXT,     // espera ',' ou '}'
+  PS_DONE,     // objeto fechado, espera fim da linha
+  PS_ERROR,    // linha inválida, ignora até o '\n'
+};
+
+struct TelemetryParser {
+  ParseState state = PS_START;
+  uint32_t keyHash = 0;     // hash da chave, calculado byte a byte
+  uint8_t keyLen = 0;
+  int8_t  field = -1;       // índice em FIELDS ou -1 (chave desconhecida)
+  char    str[12];
+  uint8_t strLen = 0;
+  int64_t num = 0;          // cabe o carimbo u32 do host
+  bool    neg = false;
+  bool    frac = false;      // parte fracionária/expoente: ignorada
+  bool    escape = false;
+  bool    nestedStr = false;
+  uint8_t depth = 0;
+};
+
+template <class Sink>
+static void parserStep(TelemetryParser& tp, Sink& sink, char c) {
+  bool ws = (c == ' ' || c == '\t');
+
+  switch (tp.state) {
+    case PS_START:
+      if (ws) break;
+      if (c == '{') {
+        sink.begin();
+        tp.state = PS_KEY;
+      } else {
+        tp.state = PS_ERROR;
+      }
+      break;
+
+    case PS_KEY:
+      if (ws) break;
+      if (c == '"') {
+        tp.keyHash = KEYS.seed;
+        tp.keyLen = 0;
+        tp.state = PS_KEY_STR;
+      } else if (c == '}') {
+        tp.state = PS_DONE;
+      } else {
+        tp.state = PS_ERROR;
+      }
+      break;
+
+    case PS_KEY_STR:
+      if (c == '"') {
+        tp.field = lookupKey(tp.keyHash, tp.keyLen);
+        tp.state = PS_COLON;
+      } else if (c == '\\' || tp.keyLen == 0xFF) {
+        tp.keyLen = 0xFF;  // escape ou chave enorme: nunca casa
+      } else {
+        tp.keyHash = keyHashStep(tp.keyHash, c);
+        tp.keyLen++;
+      }
+      break;
+
+    case PS_COLON:
+      if (ws) break;
+      tp.state = (c == ':') ? PS_VALUE : PS_ERROR;
+      break;
+
+    case PS_VALUE:
+      if (ws) break;
+      if (c == '"') {
+        tp.strLen = 0;
+        tp.escape = false;
+        tp.state = PS_STRING;
+      } else if (c == '-' || (c >= '0' && c <= '9')) {
+        tp.neg  = (c == '-');
+        tp.num  = tp.neg ? 0 : c - '0';
+        tp.frac = false;
+        tp.state = PS_NUMBER;
+      } else if (c == '{' || c == '[') {
+        tp.depth = 1;
+        tp.nestedStr = false;
+        tp.escape = false;
+        tp.state = PS_NESTED;
+      } else if (c == 't' || c == 'f' || c == 'n') {
+        tp.state = PS_LITERAL;
+      } else {
+        tp.state = PS_ERROR;
+      }
+      break;
+
+    case PS_NUMBER:
+      if (c >= '0' && c <= '9') {
+        if (!tp.frac && tp.num < 10000000000LL) tp.num = tp.num * 10 + (c - '0');
+      } else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+        tp.frac = true;
+      } else {
+        sink.number(tp.field, tp.neg ? -tp.num : tp.num);
+        tp.state = PS_NEXT;
+        parserStep(tp, sink, c);
+      }
+      break;
+
+    case PS_STRING:
+      if (tp.escape) {
+        tp.escape = false;
+      } else if (c == '\\') {
+        tp.escape = true;
+        break;
+      } else if (c == '"') {
+        tp.str[tp.strLen] = '\0';
+        sink.string(tp.field, tp.str);
+        tp.state = PS_NEXT;
+        break;
+      }
+      if (tp.strLen < sizeof(tp.str) - 1) tp.str[tp.strLen++] = c;
+      break;
+
+    case PS_LITERAL:
+      if (c >= 'a' && c <= 'z') break;
+      tp.state = PS_NEXT;
+      parserStep(tp, sink, c);
+      break;
+
+    case PS_NESTED:
+      if (tp.nestedStr) {
+        if (tp.escape)        tp.escape = false;
+        else if (c == '\\')   tp.escape = true;
+        else if (c == '"')    tp.nestedStr = false;
+      } else if (c == '"') {
+        tp.nestedStr = true;
+      } else if (c == '{' || c == '[') {
+        tp.depth++;
+      } else if ((c == '}' || c == ']') && --tp.depth == 0) {
+        tp.state = PS_NEXT;
+      }
+      break;
+
+    case PS_NEXT:
+      if (ws) break;
+      if (c == ',')      tp.state = PS_KEY;
+      else if (c == '}') tp.state = PS_DONE;
+      else               tp.state = PS_ERROR;
+      break;
+
+    case PS_DONE:
+      if (!ws) tp.state = PS_ERROR;
+      break;
+
+    case PS_ERROR:
+      break;
+  }
+}
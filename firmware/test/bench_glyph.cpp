@@ -0,0 +1,42 @@
+// ============================================================
+// Texto grande: atlas de glifos x drawString GLCD (um fillRect por
+// pixel aceso, como o TFT_eSPI em textSize > 1). Conta fillRect e
+// mede o tempo por desenho num sprite falso de 320x170 em RGB565.
+// O custo por fillRect no ESP32 (recorte, janela, laço) é maior que
+// o daqui: a contagem é o número que vale para a placa.
+// ============================================================
+#include <stdio.h>
+#include <chrono>
+#include "canvas.h"
+#include "glcd_font.h"
+
+static Glyph atlas[GLYPH_COUNT];
+static CountingSprite sprite;
+
+template <class Draw>
+static double nsPerDraw(Draw draw, long& fills) {
+  const int reps = 20000;
+  sprite.clear();
+  draw();
+  fills = sprite.fills;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < reps; i++) draw();
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return s / reps * 1e9;
+}
+
+static void bench(const char* name, const char* text, int cx, int cy, int size) {
+  long glcdFills, atlasFills;
+  double glcdNs = nsPerDraw([&] { glcdDrawString(sprite, text, cx, cy, size, 0xFFFF); }, glcdFills);
+  double atlasNs = nsPerDraw([&] { glyphDraw(sprite, atlas, text, cx, cy, size, 0xFFFF); }, atlasFills);
+  printf("%-18s glcd %4ld fillRect %7.0f ns   atlas %3ld fillRect %7.0f ns   (%.1fx)\n",
+         name, glcdFills, glcdNs, atlasFills, atlasNs, glcdNs / atlasNs);
+}
+
+int main() {
+  glcdBuildAtlas(atlas);
+  bench("fps \"144\" x7", "144", 160, 78, 7);
+  bench("relógio \"23:59\" x4", "23:59", 225, 38, 4);
+  return 0;
+}
@@ -0,0 +1,93 @@
+// ============================================================
+// Custo por frame dos gráficos: uma amostra nova (uma coluna +
+// cópia do retângulo) x redesenho das 320 colunas (escala mudou ou
+// gráfico trocado). A cópia é a do graphBlit em 4bpp.
+// ============================================================
+#include <stdio.h>
+#include <chrono>
+#include "graph.h"
+
+static const int FPS_H = 56, TEMP_H = 14;
+static const int16_t FPS_STEPS[] = { 60, 120, 165, 240, 360, 500, 1000, 0 };
+
+static MetricHistory fps, cpuTemp, gpuTemp;
+static uint8_t fpsPx[HISTORY_LEN * FPS_H], tempPx[HISTORY_LEN * TEMP_H];
+static Graph fpsGraph  = { 0, 60, HISTORY_LEN, FPS_H, GRAPH_AREA, 2, 1, {{&fps, 3}},
+                           0, 60, FPS_STEPS, fpsPx, 0, 0 };
+static Graph tempGraph = { 0, 120, HISTORY_LEN, TEMP_H, GRAPH_LINE, 0, 2,
+                           {{&cpuTemp, 1}, {&gpuTemp, 4}}, 30, 100, nullptr, tempPx, 0, 0 };
+
+static uint8_t sprite4[170][320 / 2];  // frame 4bpp
+static uint32_t rng = 12345;
+
+static int noise(int span) {
+  rng = rng * 1103515245u + 12345u;
+  return (int)((rng >> 16) % (uint32_t)span);
+}
+
+static void pushSample() {
+  historyPush(fps, 130 + noise(30));
+  historyPush(cpuTemp, 55 + noise(10));
+  historyPush(gpuTemp, 62 + noise(8));
+}
+
+static void blit(const Graph& g) {
+  uint8_t line[HISTORY_LEN];
+  for (int y = 0; y < g.h; y++) {
+    graphRow(g, y, line);
+    uint8_t* dst = sprite4[g.y + y];
+    for (int i = 0; i < g.w; i += 2) *dst++ = (line[i] << 4) | line[i + 1];
+  }
+}
+
+template <class Step>
+static void bench(const char* name, Step step) {
+  const int frames = 20000;
+  double updateS = 0, blitS = 0;
+  for (int f = 0; f < frames; f++) {
+    step();
+    auto t0 = std::chrono::steady_clock::now();
+    graphUpdate(fpsGraph);
+    graphUpdate(tempGraph);
+    auto t1 = std::chrono::steady_clock::now();
+    blit(fpsGraph);
+    blit(tempGraph);
+    auto t2 = std::chrono::steady_clock::now();
+    updateS += std::chrono::duration<double>(t1 - t0).count();
+    blitS   += std::chrono::duration<double>(t2 - t1).count();
+  }
+  printf("%-22s colunas %6.2f µs  cópia %6.2f µs  frame %6.2f µs\n", name,
+         updateS / frames * 1e6, blitS / frames * 1e6, (updateS + blitS) / frames * 1e6);
+}
+
+static bool sameAsFullRedraw(Graph& g) {
+  // O incremental tem que dar os mesmos pixels que o redesenho completo
+  uint8_t a[HISTORY_LEN], b[HISTORY_LEN];
+  static uint8_t copy[HISTORY_LEN * FPS_H];
+  Graph full = g;
+  full.px = copy;
+  full.seen = 0;
+  graphUpdate(full);
+  for (int y = 0; y < g.h; y++) {
+    graphRow(g, y, a);
+    graphRow(full, y, b);
+    if (memcmp(a, b, g.w)) return false;
+  }
+  return true;
+}
+
+int main() {
+  for (int i = 0; i < HISTORY_LEN; i++) pushSample();
+  graphUpdate(fpsGraph);
+  graphUpdate(tempGraph);
+
+  bench("1 amostra nova", [] { pushSample(); });
+  bench("320 colunas (todas)", [] {
+    pushSample();
+    fpsGraph.seen = tempGraph.seen = 0;
+  });
+  printf("incremental = redesenho completo: %s\n",
+         sameAsFullRedraw(fpsGraph) && sameAsFullRedraw(tempGraph) ? "sim" : "NÃO");
+  printf("(FPS 320x%d área + temps 320x%d duas linhas, por frame)\n", FPS_H, TEMP_H);
+  return 0;
+}
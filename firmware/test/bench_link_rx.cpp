@@ -0,0 +1,73 @@
+// ============================================================
+// Vazão do LinkRx (bytes/s): separação + COBS + CRC dos frames,
+// em blocos de RX_CHUNK_SIZE como o readSerial(). Tráfego típico
+// do monitor.py: deltas JSON e frames binários com lote.
+// ============================================================
+#include <chrono>
+#include "wire.h"
+
+static Bytes jsonTraffic() {
+  Bytes in;
+  for (int k = 0; k < 256; k++) {
+    append(in, "{\"seq\":" + std::to_string(k) + ",\"ts\":" + std::to_string(1000 + 100 * k) +
+               ",\"cpu\":" + std::to_string(k % 100) + ",\"fps\":" + std::to_string(140 + k % 20) +
+               ",\"gpu_temp\":" + std::to_string(60 + k % 9) + "}\n");
+  }
+  return in;
+}
+
+static Bytes binTraffic() {
+  // Delta com 3 campos + lote de 2 amostras (6 métricas), ~40 bytes no fio
+  Bytes in;
+  for (int k = 0; k < 256; k++) {
+    Bytes p = { (uint8_t)k, (uint8_t)k, 0x10, 0, 0, 0x23, 0x00,
+                (uint8_t)(k % 100), (uint8_t)(k % 50), (uint8_t)(140 + k % 20), 0 };
+    Bytes batch = { 2, 0x3F, 0x00 };
+    for (int s = 0; s < 2; s++) {
+      Bytes smp = { (uint8_t)(50 * s), 0, (uint8_t)k, 40, 60, 70, 65, (uint8_t)(140 + s), 0 };
+      append(batch, smp);
+    }
+    append(p, batch);
+    append(in, encodeFrame(3, 0x02, p));
+  }
+  return in;
+}
+
+static void bench(const char* name, const Bytes& traffic) {
+  const size_t target = 64u << 20;
+  LinkRx rx;
+  size_t bytes = 0, messages = 0, bad = 0;
+
+  auto t0 = std::chrono::steady_clock::now();
+  while (bytes < target) {
+    for (size_t at = 0; at < traffic.size(); at += RX_CHUNK_SIZE) {
+      size_t n = std::min(RX_CHUNK_SIZE, traffic.size() - at);
+      for (size_t i = 0; i < n; i++) {
+        switch (rxPush(rx, traffic[at + i])) {
+          case RX_LINE_END:
+            messages++;
+            break;
+          case RX_FRAME: {
+            size_t len = cobsDecode(rx.frame, rx.frameLen);
+            if (len < 4 || crc16(rx.frame, len - 2) != (rx.frame[len - 2] | (rx.frame[len - 1] << 8))) bad++;
+            messages++;
+            break;
+          }
+          default:
+            break;
+        }
+      }
+    }
+    bytes += traffic.size();
+  }
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  printf("%-5s %7.1f MB/s  %6.2f M msg/s  (%zu B/msg, %zu inválidas)\n",
+         name, bytes / s / 1e6, messages / s / 1e6, traffic.size() / 256, bad);
+}
+
+int main() {
+  bench("json", jsonTraffic());
+  bench("bin", binTraffic());
+  return 0;
+}
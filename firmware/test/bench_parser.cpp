@@ -0,0 +1,150 @@
+// ============================================================
+// Parser streaming (telemetry.h) x caminho antigo com ArduinoJson
+// (StaticJsonDocument<384> por linha + cópia para HWData). Mede
+// linhas/s e o custo por byte das mensagens que o monitor.py manda.
+//
+// O lado ArduinoJson só entra se <ArduinoJson.h> estiver no include
+// path: run.sh usa o que o PlatformIO baixou em .pio/libdeps ou o
+// diretório em $ARDUINOJSON.
+// ============================================================
+#include <chrono>
+#include <string>
+#include <vector>
+#include "telemetry.h"
+
+#if __has_include(<ArduinoJson.h>)
+#include <ArduinoJson.h>
+#define HAVE_ARDUINOJSON 1
+#endif
+
+static const size_t TARGET_BYTES = 64u << 20;
+
+struct Sink {
+  HWData    hw;
+  StageMeta st;
+  HWData    base;
+
+  void begin()                          { hw = base; st = StageMeta(); }
+  void number(int field, int64_t v)     { applyNumber(hw, st, field, v); }
+  void string(int field, const char* v) { applyString(hw, st, field, v); }
+};
+
+static volatile int sinkHole;  // impede o compilador de descartar o trabalho
+
+static std::vector<std::string> fullLines() {
+  // Formato do monitor.py original: json.dumps com espaços, todos os campos
+  std::vector<std::string> v;
+  for (int k = 0; k < 64; k++) {
+    v.push_back("{\"cpu\": " + std::to_string(k % 100) + ", \"gpu\": " + std::to_string(90 - k % 50) +
+                ", \"ram\": 41, \"cpu_temp\": " + std::to_string(60 + k % 20) +
+                ", \"gpu_temp\": 68, \"fps\": " + std::to_string(140 + k) +
+                ", \"cpu_clk\": 4650, \"gpu_clk\": 1905, \"time\": \"12:" +
+                std::to_string(10 + k % 50) + "\", \"date\": \"16 Oct\"}");
+  }
+  return v;
+}
+
+static std::vector<std::string> deltaLines() {
+  // Delta compacto de hoje: seq/ts e 2-3 campos
+  std::vector<std::string> v;
+  for (int k = 0; k < 64; k++) {
+    v.push_back("{\"seq\":" + std::to_string(k) + ",\"ts\":" + std::to_string(3000000 + 16 * k) +
+                ",\"cpu\":" + std::to_string(k % 100) + ",\"fps\":" + std::to_string(140 + k) + "}");
+  }
+  return v;
+}
+
+struct Timing {
+  double seconds;
+  size_t bytes, lines;
+};
+
+template <class Fn>
+static Timing timeLines(const std::vector<std::string>& lines, Fn parseLine) {
+  size_t lineBytes = 0;
+  for (const std::string& l : lines) lineBytes += l.size() + 1;
+
+  Timing t = {};
+  auto t0 = std::chrono::steady_clock::now();
+  while (t.bytes < TARGET_BYTES) {
+    for (const std::string& l : lines) parseLine(l);
+    t.bytes += lineBytes;
+    t.lines += lines.size();
+  }
+  t.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return t;
+}
+
+static void streaming(const std::string& line) {
+  // Byte a byte, como chega do LinkRx
+  static TelemetryParser tp;
+  static Sink sink;
+  for (char c : line) parserStep(tp, sink, c);
+  if (tp.state == PS_DONE) sink.base = sink.hw;
+  tp.state = PS_START;
+  sinkHole = sink.base.cpu;
+}
+
+#ifdef HAVE_ARDUINOJSON
+static int clampInt(int v, int lo, int hi) {
+  return v < lo ? lo : v > hi ? hi : v;
+}
+
+static void arduinoJson(const std::string& line) {
+  // parseJson() do firmware original, sem o String intermediário
+  static HWData hw;
+  StaticJsonDocument<384> doc;
+  if (deserializeJson(doc, line.data(), line.size())) return;
+
+  hw.cpu      = clampInt(doc["cpu"]      | 0, 0, 100);
+  hw.gpu      = clampInt(doc["gpu"]      | 0, 0, 100);
+  hw.ram      = clampInt(doc["ram"]      | 0, 0, 100);
+  hw.cpu_temp = clampInt(doc["cpu_temp"] | 0, 0, 120);
+  hw.gpu_temp = clampInt(doc["gpu_temp"] | 0, 0, 120);
+  hw.fps      = clampInt(doc["fps"]      | 0, 0, 9999);
+  hw.cpu_clk  = clampInt(doc["cpu_clk"]  | 0, 0, 9999);
+  hw.gpu_clk  = clampInt(doc["gpu_clk"]  | 0, 0, 9999);
+
+  const char* t = doc["time"] | "";
+  if (strlen(t) > 0) {
+    strncpy(hw.hora, t, sizeof(hw.hora) - 1);
+    hw.hora[sizeof(hw.hora) - 1] = '\0';
+  }
+  const char* d = doc["date"] | "";
+  if (strlen(d) > 0) {
+    strncpy(hw.data, d, sizeof(hw.data) - 1);
+    hw.data[sizeof(hw.data) - 1] = '\0';
+  }
+  sinkHole = hw.cpu;
+}
+#endif
+
+template <class Fn>
+static double report(const char* name, const std::vector<std::string>& lines, Fn parseLine) {
+  Timing t = timeLines(lines, parseLine);
+  double ns = t.seconds * 1e9 / t.lines;
+  printf("  %-12s %7.1f MB/s  %7.0f ns/linha  %5.2f ns/byte\n",
+         name, t.bytes / t.seconds / 1e6, ns, t.seconds * 1e9 / t.bytes);
+  return ns;
+}
+
+static void bench(const char* name, const std::vector<std::string>& lines) {
+  size_t avg = 0;
+  for (const std::string& l : lines) avg += l.size() + 1;
+  printf("%s (%zu B/linha)\n", name, avg / lines.size());
+
+  double stream = report("streaming", lines, streaming);
+#ifdef HAVE_ARDUINOJSON
+  double doc = report("ArduinoJson", lines, arduinoJson);
+  printf("  streaming %.1fx mais rápido\n", doc / stream);
+#else
+  (void)stream;
+  printf("  ArduinoJson: <ArduinoJson.h> não encontrado (defina ARDUINOJSON)\n");
+#endif
+}
+
+int main() {
+  bench("completa", fullLines());
+  bench("delta", deltaLines());
+  return 0;
+}
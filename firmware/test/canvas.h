@@ -0,0 +1,28 @@
+// ============================================================
+// Sprite falso dos testes: framebuffer RGB565 de 320x170 com o
+// recorte do TFT_eSprite e um contador de fillRect.
+// ============================================================
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+struct CountingSprite {
+  static const int W = 320;
+  static const int H = 170;
+  uint16_t px[H][W];
+  long     fills = 0;
+
+  CountingSprite() { clear(); }
+  void clear() { memset(px, 0, sizeof(px)); fills = 0; }
+
+  void fillRect(int x, int y, int w, int h, uint16_t color) {
+    fills++;
+    int x0 = std::max(x, 0), y0 = std::max(y, 0);
+    int x1 = std::min(x + w, W), y1 = std::min(y + h, H);
+    for (int r = y0; r < y1; r++) {
+      for (int c = x0; c < x1; c++) px[r][c] = color;
+    }
+  }
+};
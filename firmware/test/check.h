@@ -0,0 +1,32 @@
+// ============================================================
+// Mini-harness dos testes nativos (sem Unity/PlatformIO)
+// CHECK registra a falha e segue; o main termina com checkExit().
+// ============================================================
+#pragma once
+
+#include <stdio.h>
+
+static int checkFailures = 0;
+
+#define CHECK(cond)                                                   \
+  do {                                                                \
+    if (!(cond)) {                                                    \
+      printf("%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond);       \
+      checkFailures++;                                                \
+    }                                                                 \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                \
+  do {                                                                \
+    long long va_ = (long long)(a), vb_ = (long long)(b);             \
+    if (va_ != vb_) {                                                 \
+      printf("%s:%d: falhou: %s == %s (%lld != %lld)\n",              \
+             __FILE__, __LINE__, #a, #b, va_, vb_);                   \
+      checkFailures++;                                                \
+    }                                                                 \
+  } while (0)
+
+static int checkExit(const char* name) {
+  printf("%s: %s\n", name, checkFailures ? "FALHOU" : "ok");
+  return checkFailures ? 1 : 0;
+}
@@ -0,0 +1,58 @@
+// ============================================================
+// Fonte GLCD 5x7 (a "fonte 1" do TFT_eSPI, Fonts/glcdfont.c), só
+// os caracteres do atlas, e o drawChar dela como o TFT_eSPI faz em
+// textSize > 1: um fillRect size x size por pixel aceso.
+// ============================================================
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "glyph_atlas.h"
+
+// Uma coluna por byte, bit 0 em cima; na ordem de GLYPH_CHARS
+static const uint8_t GLCD_COLUMNS[GLYPH_COUNT][5] = {
+  { 0x3E, 0x51, 0x49, 0x45, 0x3E },  // 0
+  { 0x00, 0x42, 0x7F, 0x40, 0x00 },  // 1
+  { 0x42, 0x61, 0x51, 0x49, 0x46 },  // 2
+  { 0x21, 0x41, 0x45, 0x4B, 0x31 },  // 3
+  { 0x18, 0x14, 0x12, 0x7F, 0x10 },  // 4
+  { 0x27, 0x45, 0x45, 0x45, 0x39 },  // 5
+  { 0x3C, 0x4A, 0x49, 0x49, 0x30 },  // 6
+  { 0x01, 0x71, 0x09, 0x05, 0x03 },  // 7
+  { 0x36, 0x49, 0x49, 0x49, 0x36 },  // 8
+  { 0x06, 0x49, 0x49, 0x29, 0x1E },  // 9
+  { 0x00, 0x36, 0x36, 0x00, 0x00 },  // :
+  { 0x08, 0x08, 0x08, 0x08, 0x08 },  // -
+};
+
+static inline bool glcdLit(char c, int x, int y) {
+  // Coluna 5 é o espaçamento (sempre apagada), como no drawChar
+  const char* p = strchr(GLYPH_CHARS, c);
+  if (!p || c == '\0' || x >= 5) return false;
+  return (GLCD_COLUMNS[p - GLYPH_CHARS][x] >> y) & 1;
+}
+
+static inline void glcdBuildAtlas(Glyph* atlas) {
+  // O que o buildGlyphAtlas() do firmware lê da célula rasterizada
+  for (int g = 0; g < GLYPH_COUNT; g++) {
+    char c = GLYPH_CHARS[g];
+    glyphBuild(atlas[g], [c](int x, int y) { return glcdLit(c, x, y); });
+  }
+}
+
+template <class Canvas>
+static void glcdDrawString(Canvas& cv, const char* text, int cx, int cy, int size, uint16_t color) {
+  // drawString(text, cx, cy) com MC_DATUM e fonte GLCD, fundo transparente
+  int len = (int)strlen(text);
+  int x = cx - len * GLYPH_W * size / 2;
+  int y = cy - (GLYPH_H * size - 1) / 2;
+  for (int i = 0; i < len; i++, x += GLYPH_W * size) {
+    for (int col = 0; col < GLYPH_W; col++) {
+      for (int row = 0; row < GLYPH_H; row++) {
+        if (glcdLit(text[i], col, row)) {
+          cv.fillRect(x + col * size, y + row * size, size, size, color);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,26 @@
+#!/bin/sh
+# Testes e benchmarks nativos do firmware (g++ no Linux, sem placa)
+#   firmware/test/run.sh          roda os test_*.cpp
+#   firmware/test/run.sh bench    roda os bench_*.cpp
+set -e
+cd "$(dirname "$0")"
+
+CXX=${CXX:-g++}
+OUT=${OUT:-${TMPDIR:-/tmp}/hwmonitor-test}
+FLAGS="-std=gnu++17 -O2 -Wall -Wextra -I../src -pthread $CXXFLAGS"
+
+# bench_parser compara com o ArduinoJson que o PlatformIO baixou (pio run)
+ARDUINOJSON=${ARDUINOJSON:-../.pio/libdeps/lilygo-t-display-s3/ArduinoJson/src}
+[ -f "$ARDUINOJSON/ArduinoJson.h" ] && FLAGS="$FLAGS -I$ARDUINOJSON"
+mkdir -p "$OUT"
+
+prefix=test_
+[ "$1" = bench ] && prefix=bench_
+
+status=0
+for src in $prefix*.cpp; do
+  bin="$OUT/${src%.cpp}"
+  $CXX $FLAGS "$src" -o "$bin"
+  "$bin" || status=1
+done
+exit $status
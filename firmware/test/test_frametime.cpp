@@ -0,0 +1,135 @@
+// ============================================================
+// Estimador de tempos de frame (frametime.h) contra percentis
+// exatos nos traces de traces/*.txt: p99/p99,9 do histograma a
+// ≤1,6% do valor exato, FPS médio exato e lows a ≤1,6% + 0,5 FPS.
+// ============================================================
+#include <dirent.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "frametime.h"
+
+static const char* TRACE_DIR = "traces";
+
+static std::vector<uint32_t> loadTrace(const std::string& path) {
+  std::vector<uint32_t> v;
+  FILE* f = fopen(path.c_str(), "r");
+  if (!f) return v;
+  char line[64];
+  while (fgets(line, sizeof(line), f)) {
+    if (line[0] == '#' || line[0] == '\n') continue;
+    v.push_back((uint32_t)strtoul(line, nullptr, 10));
+  }
+  fclose(f);
+  return v;
+}
+
+static uint32_t exactSlowest(std::vector<uint32_t> v, uint32_t perMille) {
+  // Mesma definição do firmware: o want-ésimo maior tempo
+  std::sort(v.begin(), v.end(), std::greater<uint32_t>());
+  size_t want = std::max<size_t>(1, (v.size() * perMille + 999) / 1000);
+  return v[want - 1];
+}
+
+static double relErr(double got, double want) {
+  return fabs(got - want) / want;
+}
+
+static bool fpsClose(uint16_t got, double want) {
+  // Erro do bucket (≤1,6%) mais o arredondamento para FPS inteiro
+  return fabs(got - want) <= want / 64 + 0.5;
+}
+
+static void checkTrace(const std::string& name, const std::vector<uint32_t>& trace) {
+  // Metade em cada janela, como o drainFrameTimes() depois de uma troca
+  static FrameTimeHist h[2];
+  memset(h, 0, sizeof(h));
+  uint64_t sum = 0;
+  for (size_t i = 0; i < trace.size(); i++) {
+    frameTimeAdd(h[i < trace.size() / 2 ? 0 : 1], trace[i]);
+    sum += trace[i];
+  }
+
+  uint32_t p99  = exactSlowest(trace, 10);
+  uint32_t p999 = exactSlowest(trace, 1);
+  uint32_t e99  = frameTimePercentile(h[0], h[1], 10);
+  uint32_t e999 = frameTimePercentile(h[0], h[1], 1);
+  FrameStats st = frameTimeStats(h[0], h[1]);
+
+  double avg = trace.size() * 1e6 / sum;
+  printf("  %-22s avg %4u (%.1f)  1%% low %4u (%.1f)  0,1%% low %4u (%.1f)\n", name.c_str(),
+         st.avg, avg, st.low1, 1e6 / p99, st.low01, 1e6 / p999);
+
+  CHECK(relErr(e99, p99) <= 1.0 / 64);
+  CHECK(relErr(e999, p999) <= 1.0 / 64);
+  CHECK(fabs(st.avg - avg) <= 0.5);  // média vem das somas exatas
+  CHECK(fpsClose(st.low1, 1e6 / p99));
+  CHECK(fpsClose(st.low01, 1e6 / p999));
+  CHECK(st.low01 <= st.low1 && st.low1 <= st.avg + 1);
+}
+
+static void testTraces() {
+  DIR* dir = opendir(TRACE_DIR);
+  CHECK(dir != nullptr);
+  if (!dir) return;
+
+  std::vector<std::string> names;
+  while (dirent* e = readdir(dir)) {
+    size_t n = strlen(e->d_name);
+    if (n > 4 && !strcmp(e->d_name + n - 4, ".txt")) names.push_back(e->d_name);
+  }
+  closedir(dir);
+  std::sort(names.begin(), names.end());
+  CHECK(names.size() >= 4);
+
+  for (const std::string& name : names) {
+    std::vector<uint32_t> trace = loadTrace(std::string(TRACE_DIR) + "/" + name);
+    CHECK(trace.size() >= 1000);
+    if (!trace.empty()) checkTrace(name, trace);
+  }
+}
+
+static void testBuckets() {
+  // Buckets monótonos, exatos abaixo de 64 µs e ponto médio a ≤1,6%
+  int prev = -1;
+  for (uint32_t us = 0; us <= FT_MAX_US; us++) {
+    int b = frameTimeBucket(us);
+    if (b < prev || b >= FT_BUCKETS) {
+      CHECK(b >= prev && b < FT_BUCKETS);
+      return;
+    }
+    prev = b;
+    uint32_t mid = frameTimeBucketMid(b);
+    if (us < 64 ? mid != us : relErr(mid, us) > 1.0 / 62) {
+      printf("  us %u bucket %d meio %u\n", us, b, mid);
+      CHECK(false);
+      return;
+    }
+  }
+  CHECK_EQ(frameTimeBucket(FT_MAX_US + 12345), frameTimeBucket(FT_MAX_US));
+}
+
+static void testEmptyAndSingle() {
+  static FrameTimeHist a, b;
+  memset(&a, 0, sizeof(a));
+  memset(&b, 0, sizeof(b));
+  FrameStats st = frameTimeStats(a, b);
+  CHECK(st.avg == 0 && st.low1 == 0 && st.low01 == 0);
+
+  frameTimeAdd(b, 16670);
+  st = frameTimeStats(a, b);
+  CHECK_EQ(st.avg, 60);
+  CHECK(st.low1 >= 59 && st.low1 <= 61);
+}
+
+int main() {
+  testBuckets();
+  testEmptyAndSingle();
+  testTraces();
+  return checkExit("frametime");
+}
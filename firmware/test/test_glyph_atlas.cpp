@@ -0,0 +1,50 @@
+// ============================================================
+// Atlas de glifos: os retângulos pintam exatamente os pixels do
+// drawString GLCD (fillRect por pixel) em toda escala e posição.
+// ============================================================
+#include "check.h"
+#include "canvas.h"
+#include "glcd_font.h"
+
+static Glyph atlas[GLYPH_COUNT];
+static CountingSprite ref, fast;
+
+static bool samePixels(const char* text, int cx, int cy, int size) {
+  ref.clear();
+  fast.clear();
+  glcdDrawString(ref, text, cx, cy, size, 0xFFFF);
+  bool drawn = glyphDraw(fast, atlas, text, cx, cy, size, 0xFFFF);
+  return drawn && memcmp(ref.px, fast.px, sizeof(ref.px)) == 0 && fast.fills <= ref.fills;
+}
+
+static void testEveryGlyphEveryScale() {
+  for (int g = 0; g < GLYPH_COUNT; g++) {
+    CHECK(atlas[g].n > 0);
+    char text[2] = { GLYPH_CHARS[g], '\0' };
+    for (int size = 1; size <= 8; size++) CHECK(samePixels(text, 40, 40, size));
+  }
+}
+
+static void testScreenLabels() {
+  // FPS gigante da tela de jogo e relógio da idle, cortes na borda inclusive
+  CHECK(samePixels("144", 160, 78, 7));
+  CHECK(samePixels("9999", 160, 78, 7));
+  CHECK(samePixels("23:59", 225, 38, 4));
+  CHECK(samePixels("--:--", 225, 38, 4));
+  CHECK(samePixels("0123456789", 310, 165, 3));
+}
+
+static void testFallback() {
+  // Caractere fora do atlas: nada desenhado, o firmware cai no drawString
+  fast.clear();
+  CHECK(!glyphDraw(fast, atlas, "14a", 160, 78, 7, 0xFFFF));
+  CHECK_EQ(fast.fills, 0);
+}
+
+int main() {
+  glcdBuildAtlas(atlas);
+  testEveryGlyphEveryScale();
+  testScreenLabels();
+  testFallback();
+  return checkExit("glyph_atlas");
+}
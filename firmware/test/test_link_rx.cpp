@@ -0,0 +1,211 @@
+// ============================================================
+// LinkRx: separação de linhas JSON e frames COBS, limites de
+// tamanho e independência do tamanho do bloco lido do Serial.
+// ============================================================
+#include <string.h>
+#include <algorithm>
+#include "check.h"
+#include "wire.h"
+
+// Evento por byte, com o frame decodificado quando completa
+struct Trace {
+  std::string events;  // uma letra por evento != RX_NONE
+  std::string text;    // bytes RX_CHAR
+  std::vector<Bytes> frames;
+};
+
+static void feed(LinkRx& rx, const Bytes& in, size_t chunk, Trace& t) {
+  // Mesmo laço do readSerial(): blocos de até chunk bytes
+  for (size_t at = 0; at < in.size(); at += chunk) {
+    size_t n = std::min(chunk, in.size() - at);
+    for (size_t i = 0; i < n; i++) {
+      uint8_t c = in[at + i];
+      switch (rxPush(rx, c)) {
+        case RX_CHAR:     t.events += 'c'; t.text += (char)c; break;
+        case RX_LINE_END: t.events += 'L'; t.text += '|';     break;
+        case RX_LINE_CUT: t.events += 'X'; break;
+        case RX_OVERFLOW: t.events += 'O'; break;
+        case RX_FRAME: {
+          t.events += 'F';
+          Bytes f(rx.frame, rx.frame + rx.frameLen);
+          f.resize(cobsDecode(f.data(), f.size()));
+          t.frames.push_back(f);
+          break;
+        }
+        default: break;
+      }
+    }
+  }
+}
+
+static Trace run(const Bytes& in, size_t chunk = RX_CHUNK_SIZE) {
+  LinkRx rx;
+  Trace t;
+  feed(rx, in, chunk, t);
+  return t;
+}
+
+static void testJsonLines() {
+  Bytes in;
+  append(in, std::string("{\"cpu\":5}\n\r\n{\"gpu\":7}\r"));
+  Trace t = run(in);
+  CHECK(t.text == "{\"cpu\":5}|||{\"gpu\":7}|");
+  CHECK(t.frames.empty());
+}
+
+static void testFrameFromHost() {
+  // monitor.encode_frame(FRAME_KEYFRAME, pack("<BIH", 1, 1000, 0x21) + [55, 400 LE])
+  static const uint8_t ref[] = {
+    0x00, 0x06, 0x03, 0x01, 0x01, 0xe8, 0x03, 0x01, 0x02,
+    0x21, 0x06, 0x37, 0x90, 0x01, 0x6d, 0x7a, 0x00,
+  };
+  Bytes payload = { 0x01, 0xe8, 0x03, 0x00, 0x00, 0x21, 0x00, 55, 0x90, 0x01 };
+  Bytes frame = encodeFrame(3, 0x01, payload);
+  CHECK(frame == Bytes(ref, ref + sizeof(ref)));
+
+  Trace t = run(frame);
+  CHECK(t.events == "XF");
+  CHECK_EQ(t.frames.size(), 1);
+  const Bytes& f = t.frames[0];
+  CHECK_EQ(f.size(), 2 + payload.size() + 2);
+  CHECK_EQ(crc16(f.data(), f.size() - 2), f[f.size() - 2] | (f[f.size() - 1] << 8));
+  CHECK(Bytes(f.begin() + 2, f.end() - 2) == payload);
+}
+
+static void testMixedStream() {
+  // JSON e frames intercalados, frames colados (0x00 0x00) e 0x00 repetido
+  Bytes in;
+  append(in, std::string("{\"cmd\":\"hello\"}\n"));
+  append(in, encodeFrame(3, 0x02, { 1, 2, 3 }));
+  append(in, encodeFrame(3, 0x02, { 0, 0, 0 }));
+  in.push_back(0x00);
+  append(in, encodeFrame(3, 0x03, { 0 }));
+  append(in, std::string("{\"cmd\":\"stats\"}\n"));
+
+  Trace t = run(in);
+  CHECK(t.text == "{\"cmd\":\"hello\"}|{\"cmd\":\"stats\"}|");
+  CHECK_EQ(t.frames.size(), 3);
+  CHECK(t.frames.size() == 3 && t.frames[1] == Bytes({ 3, 2, 0, 0, 0,
+        (uint8_t)(crc16(t.frames[1].data(), 5) & 0xFF), (uint8_t)(crc16(t.frames[1].data(), 5) >> 8) }));
+}
+
+static void testZeroCutsLine() {
+  Bytes in;
+  append(in, std::string("{\"cpu\":"));
+  append(in, encodeFrame(3, 0x02, { 9 }));
+  Trace t = run(in);
+  CHECK(t.events.substr(0, 8) == "cccccccX");
+  CHECK_EQ(t.frames.size(), 1);
+}
+
+static void testLineOverflow() {
+  // Passou de RX_LINE_MAX: um único overflow, o resto da linha some
+  Bytes in(RX_LINE_MAX + 100, 'a');
+  append(in, std::string("\n{}\n"));
+  Trace t = run(in);
+  CHECK_EQ(std::count(t.events.begin(), t.events.end(), 'O'), 1);
+  CHECK_EQ(std::count(t.events.begin(), t.events.end(), 'c'), RX_LINE_MAX + 2);
+  CHECK(t.text.substr(RX_LINE_MAX) == "{}|");
+}
+
+static void testFrameOverflow() {
+  // Passou de FRAME_MAX: overflow no ato, os próximos bytes já são texto
+  Bytes big(FRAME_MAX + 10, 0x55);
+  Bytes in = encodeFrame(3, 0x02, big);
+  append(in, encodeFrame(3, 0x02, { 1 }));
+  Trace t = run(in);
+  CHECK_EQ(std::count(t.events.begin(), t.events.end(), 'O'), 1);
+  CHECK(t.events.substr(0, 3) == "XOc");
+  CHECK_EQ(t.frames.size(), 1);
+}
+
+static void testHostDiedInOversizedFrame() {
+  // Host morreu no meio de um frame enorme (sem 0x00 final) e voltou:
+  // o primeiro hello cai na linha de lixo, o reenvio chega inteiro
+  Bytes in = { 0x00 };
+  append(in, Bytes(FRAME_MAX + 40, 0x41));
+  append(in, std::string("{\"cmd\":\"hello\"}\n{\"cmd\":\"hello\"}\n"));
+  Trace t = run(in);
+  CHECK_EQ(std::count(t.events.begin(), t.events.end(), 'O'), 1);
+  CHECK(t.text.size() >= 16 && t.text.substr(t.text.size() - 16) == "{\"cmd\":\"hello\"}|");
+}
+
+static void testFrameGapTimeout() {
+  // Frame parcial e silêncio: o próximo bloco volta ao modo texto
+  LinkRx rx;
+  Trace t;
+  Bytes part = encodeFrame(3, 0x02, { 1, 2, 3, 4 });
+  part.resize(5);
+
+  CHECK(!rxGapExpired(rx, 1000));
+  feed(rx, part, RX_CHUNK_SIZE, t);
+  CHECK(!rxGapExpired(rx, 1000 + RX_FRAME_GAP_MS));  // ainda dentro do prazo
+  CHECK(rx.inFrame);
+  CHECK(rxGapExpired(rx, 1000 + 3 * RX_FRAME_GAP_MS));
+  CHECK(!rx.inFrame);
+
+  Bytes hello;
+  append(hello, std::string("{\"cmd\":\"hello\"}\n"));
+  feed(rx, hello, RX_CHUNK_SIZE, t);
+  CHECK(t.text == "{\"cmd\":\"hello\"}|");
+
+  // 0x00 solto e silêncio: sai do frame sem contar overflow
+  LinkRx idle;
+  rxPush(idle, 0x00);
+  CHECK(!rxGapExpired(idle, 10 * RX_FRAME_GAP_MS));
+  CHECK(!idle.inFrame);
+}
+
+static void testChunkIndependence() {
+  // O resultado não pode depender de onde o Serial cortou os blocos
+  Bytes in;
+  for (int k = 0; k < 20; k++) {
+    append(in, std::string("{\"cpu\":") + std::to_string(k) + "}\n");
+    append(in, encodeFrame(3, 0x02, Bytes(k * 13, (uint8_t)k)));
+  }
+  Trace ref = run(in, in.size());
+  for (size_t chunk = 1; chunk <= RX_CHUNK_SIZE; chunk++) {
+    Trace t = run(in, chunk);
+    CHECK(t.events == ref.events && t.text == ref.text && t.frames == ref.frames);
+  }
+  CHECK_EQ(ref.frames.size(), 20);
+}
+
+static void testCobs() {
+  // Blocos de 254 bytes não-zero usam o código 0xFF
+  Bytes runs;
+  for (int i = 0; i < 600; i++) runs.push_back(i % 7 ? (uint8_t)i : 0);
+  Bytes all = { 0, 0, 0 };
+  Bytes plain(254, 0x11);
+
+  for (const Bytes* src : { &runs, &all, &plain }) {
+    Bytes enc = cobsEncode(*src);
+    CHECK(std::find(enc.begin(), enc.end(), 0) == enc.end());
+    size_t n = cobsDecode(enc.data(), enc.size());
+    CHECK(Bytes(enc.begin(), enc.begin() + n) == *src);
+  }
+
+  // Código apontando além do fim: corrompido
+  uint8_t bad[] = { 0x05, 0x01, 0x02 };
+  CHECK_EQ(cobsDecode(bad, sizeof(bad)), 0);
+}
+
+static void testCrc() {
+  // Vetor de referência do CRC-16/CCITT-FALSE (= binascii.crc_hqx)
+  CHECK_EQ(crc16((const uint8_t*)"123456789", 9), 0x29B1);
+}
+
+int main() {
+  testJsonLines();
+  testFrameFromHost();
+  testMixedStream();
+  testZeroCutsLine();
+  testLineOverflow();
+  testFrameOverflow();
+  testHostDiedInOversizedFrame();
+  testFrameGapTimeout();
+  testChunkIndependence();
+  testCobs();
+  testCrc();
+  return checkExit("link_rx");
+}
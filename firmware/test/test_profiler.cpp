@@ -0,0 +1,90 @@
+// ============================================================
+// Profiler: anel das últimas PROF_SAMPLES amostras, min/méd/p99
+// em µs e escopos que somam no frame ou fecham a amostra.
+// ============================================================
+#include <thread>
+#include "check.h"
+#include "profiler.h"
+
+static void add(ProfRing& r, uint32_t ticks) {
+  r.acc = ticks;
+  r.ran = true;
+  profRingCommit(r);
+}
+
+static void testEmpty() {
+  ProfRing r = {};
+  ProfStat st = profRingStat(r, 240);
+  CHECK_EQ(st.min, 0);
+  CHECK_EQ(st.avg, 0);
+  CHECK_EQ(st.p99, 0);
+
+  // Estágio que não rodou no frame não vira amostra
+  profRingCommit(r);
+  CHECK_EQ(r.count, 0);
+}
+
+static void testAggregation() {
+  // 10 amostras de 1..10 µs a 240 MHz; p99 de 10 amostras é a maior
+  ProfRing r = {};
+  for (uint32_t us = 10; us >= 1; us--) add(r, us * 240);
+  ProfStat st = profRingStat(r, 240);
+  CHECK_EQ(r.count, 10);
+  CHECK_EQ(st.min, 1);
+  CHECK_EQ(st.avg, 5);   // 5,5 truncado
+  CHECK_EQ(st.p99, 10);
+  CHECK_EQ(r.acc, 0);
+  CHECK(!r.ran);
+}
+
+static void testP99Index() {
+  // Anel cheio: 63 amostras de 100 µs e um pico de 5 ms; o p99
+  // (índice 63 de 64) é o pico, a média o absorve
+  ProfRing r = {};
+  for (int i = 0; i < PROF_SAMPLES - 1; i++) add(r, 100);
+  add(r, 5000);
+  ProfStat st = profRingStat(r, 1);
+  CHECK_EQ(st.min, 100);
+  CHECK_EQ(st.avg, (63 * 100 + 5000) / 64);
+  CHECK_EQ(st.p99, 5000);
+}
+
+static void testRingKeepsLatest() {
+  // Depois de 3 voltas só as últimas PROF_SAMPLES contam
+  ProfRing r = {};
+  for (int i = 0; i < 3 * PROF_SAMPLES; i++) add(r, i < 2 * PROF_SAMPLES ? 1000000 : 7);
+  ProfStat st = profRingStat(r, 1);
+  CHECK_EQ(r.count, PROF_SAMPLES);
+  CHECK_EQ(st.min, 7);
+  CHECK_EQ(st.p99, 7);
+}
+
+static void testScopes() {
+  // Escopos sem commit somam no frame; PROF_EVENT fecha a amostra
+  ProfRing frame = {}, event = {};
+  for (int i = 0; i < 3; i++) {
+    ProfScope s(frame, false);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  CHECK_EQ(frame.count, 0);
+  CHECK(frame.ran);
+  CHECK(frame.acc >= 3 * 1000 * profTicksPerUs());
+  profRingCommit(frame);
+  CHECK(profRingStat(frame, profTicksPerUs()).min >= 3000);
+
+  {
+    ProfScope s(event, true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  CHECK_EQ(event.count, 1);
+  CHECK(profRingStat(event, profTicksPerUs()).avg >= 2000);
+}
+
+int main() {
+  testEmpty();
+  testAggregation();
+  testP99Index();
+  testRingKeepsLatest();
+  testScopes();
+  return checkExit("profiler");
+}
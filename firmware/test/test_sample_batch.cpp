@@ -0,0 +1,117 @@
+// ============================================================
+// Lote de amostras: layout que o monitor.py gera, validação do
+// lote inteiro antes de qualquer amostra e faixas de cada métrica.
+// ============================================================
+#include "check.h"
+#include "wire.h"
+#include "sample_batch.h"
+
+// monitor.TelemetryEncoder("bin", 24)._encode_batch(...) com o relógio em
+// 10.0 s e amostras de 9.90 s e 9.95 s (mesmo vetor de host/test_monitor.py,
+// test_batch_matches_firmware_reference)
+static const uint8_t REF_BATCH[] = {
+  0x02, 0x3f, 0x00,
+  0x64, 0x00, 5, 250, 3, 45, 60, 0xa0, 0x05,
+  0x32, 0x00, 7, 8, 9, 200, 61, 0x2c, 0x01,
+};
+
+static bool open(const Bytes& b, SampleBatch& batch) {
+  return batchOpen(b.data(), b.data() + b.size(), batch);
+}
+
+static void testReferenceBatch() {
+  Bytes b(REF_BATCH, REF_BATCH + sizeof(REF_BATCH));
+  SampleBatch batch;
+  CHECK(open(b, batch));
+  CHECK_EQ(batch.n, 2);
+  CHECK_EQ(batch.mask, 0x3f);
+  CHECK_EQ(batch.recSize, 2 + 5 + 2);
+
+  HistorySample s;
+  batchSample(batch, 0, s);
+  CHECK_EQ(s.mask, 0x3f);
+  CHECK_EQ(s.v[FID_CPU], 5);
+  CHECK_EQ(s.v[FID_GPU], 100);  // 250 fora da faixa: limitado
+  CHECK_EQ(s.v[FID_CPU_TEMP], 45);
+  CHECK_EQ(s.v[FID_FPS], 1440);
+
+  batchSample(batch, 1, s);
+  CHECK_EQ(s.v[FID_RAM], 9);
+  CHECK_EQ(s.v[FID_CPU_TEMP], 120);
+  CHECK_EQ(s.v[FID_GPU_TEMP], 61);
+  CHECK_EQ(s.v[FID_FPS], 300);
+}
+
+static void testWholeBatchValidated() {
+  // Um byte a menos ou a mais: o lote inteiro é recusado, nenhuma amostra
+  SampleBatch batch;
+  Bytes b(REF_BATCH, REF_BATCH + sizeof(REF_BATCH));
+  for (size_t cut = 0; cut < b.size(); cut++) {
+    CHECK(!open(Bytes(b.begin(), b.begin() + cut), batch));
+  }
+  b.push_back(0);
+  CHECK(!open(b, batch));
+
+  // n acima do anunciado, mesmo com o tamanho certo
+  Bytes big = { BATCH_MAX + 1, 0x01, 0x00 };
+  for (int k = 0; k <= BATCH_MAX; k++) append(big, Bytes({ 0, 0, 7 }));
+  CHECK(!open(big, batch));
+  big[0] = BATCH_MAX;
+  big.resize(big.size() - 3);
+  CHECK(open(big, batch));
+}
+
+static void testPartialMask() {
+  // Só cpu e fps; bits acima das métricas do histórico são ignorados
+  Bytes b = { 2, 0x21, 0x80,  10, 0, 42, 0x3c, 0x00,  0, 0, 43, 0x3d, 0x00 };
+  SampleBatch batch;
+  CHECK(open(b, batch));
+  CHECK_EQ(batch.mask, 0x21);
+  CHECK_EQ(batch.recSize, 5);
+
+  HistorySample s;
+  batchSample(batch, 1, s);
+  CHECK_EQ(s.mask, 0x21);
+  CHECK_EQ(s.v[FID_CPU], 43);
+  CHECK_EQ(s.v[FID_GPU], 0);
+  CHECK_EQ(s.v[FID_FPS], 61);
+}
+
+static void testEmptyAndShort() {
+  SampleBatch batch;
+  CHECK(open(Bytes({ 0, 0x3f, 0x00 }), batch));
+  CHECK_EQ(batch.n, 0);
+  CHECK(!open(Bytes({ 0, 0x3f }), batch));
+  CHECK(!open(Bytes(), batch));
+}
+
+static void testBatchThroughLink() {
+  // Frame de telemetria com lote, pelo LinkRx: o lote é o resto do payload
+  Bytes payload = { 0x07, 0xe8, 0x03, 0x00, 0x00, 0x01, 0x00, 55 };
+  append(payload, Bytes(REF_BATCH, REF_BATCH + sizeof(REF_BATCH)));
+  Bytes in = encodeFrame(3, 0x02, payload);
+
+  LinkRx rx;
+  Bytes frame;
+  for (uint8_t c : in) {
+    if (rxPush(rx, c) == RX_FRAME) frame.assign(rx.frame, rx.frame + rx.frameLen);
+  }
+  frame.resize(cobsDecode(frame.data(), frame.size()));
+  CHECK_EQ(frame.size(), 2 + payload.size() + 2);
+
+  // seq | ts | máscara (só cpu) | cpu | lote
+  const uint8_t* q   = frame.data() + 2 + 7 + 1;
+  const uint8_t* end = frame.data() + frame.size() - 2;
+  SampleBatch batch;
+  CHECK(batchOpen(q, end, batch));
+  CHECK_EQ(batch.n, 2);
+}
+
+int main() {
+  testReferenceBatch();
+  testWholeBatchValidated();
+  testPartialMask();
+  testEmptyAndShort();
+  testBatchThroughLink();
+  return checkExit("sample_batch");
+}
@@ -0,0 +1,79 @@
+// ============================================================
+// Seqlock (seqlock.h) com threads de verdade: um escritor publica
+// sem parar e o leitor confere que nenhum snapshot veio rasgado
+// (campos de versões diferentes) nem voltou no tempo.
+// ============================================================
+#include <stdio.h>
+#include <thread>
+#include "check.h"
+#include "seqlock.h"
+#include "telemetry.h"
+
+static const uint32_t WRITES = 2000000;
+
+// Todo campo deriva de n: qualquer mistura de duas escritas aparece
+static HWData snapshotOf(uint32_t n) {
+  HWData d;
+  d.cpu = d.gpu = d.ram = d.cpu_temp = d.gpu_temp = (int)n;
+  d.fps = d.cpu_clk = d.gpu_clk = (int)~n;
+  snprintf(d.hora, sizeof(d.hora), "%05u", n % 100000);
+  snprintf(d.data, sizeof(d.data), "%011u", n);
+  d.sampledAt = n;
+  return d;
+}
+
+static bool consistent(const HWData& d) {
+  // Campo a campo: o padding de HWData não entra
+  HWData w = snapshotOf(d.sampledAt);
+  return d.cpu == w.cpu && d.gpu == w.gpu && d.ram == w.ram && d.cpu_temp == w.cpu_temp &&
+         d.gpu_temp == w.gpu_temp && d.fps == w.fps && d.cpu_clk == w.cpu_clk &&
+         d.gpu_clk == w.gpu_clk && !strcmp(d.hora, w.hora) && !strcmp(d.data, w.data);
+}
+
+static void testHWDataHandoff() {
+  static Seqlock<HWData> lock;
+  std::atomic<bool> done{false};
+
+  std::thread writer([&] {
+    for (uint32_t n = 1; n <= WRITES; n++) seqlockWrite(lock, snapshotOf(n));
+    done.store(true, std::memory_order_release);
+  });
+
+  uint32_t seen = 0, last = 0, reads = 0, torn = 0, backwards = 0;
+  HWData d;
+  for (;;) {
+    bool finished = done.load(std::memory_order_acquire);
+    if (seqlockRead(lock, d, seen)) {
+      reads++;
+      if (!consistent(d)) torn++;
+      if (d.sampledAt <= last) backwards++;
+      last = d.sampledAt;
+    }
+    if (finished && !seqlockRead(lock, d, seen)) break;
+  }
+  writer.join();
+
+  CHECK_EQ(torn, 0);
+  CHECK_EQ(backwards, 0);
+  CHECK(reads > 0);
+  CHECK_EQ(last, WRITES);  // o leitor sempre alcança a última versão
+  CHECK_EQ(seen, 2 * WRITES);
+  printf("seqlock: %u escritas, %u leituras sem rasgo\n", WRITES, reads);
+}
+
+static void testNothingNew() {
+  Seqlock<HWData> lock;
+  uint32_t seen = 0;
+  HWData d;
+  CHECK(!seqlockRead(lock, d, seen));
+  seqlockWrite(lock, snapshotOf(7));
+  CHECK(seqlockRead(lock, d, seen));
+  CHECK(consistent(d) && d.sampledAt == 7);
+  CHECK(!seqlockRead(lock, d, seen));
+}
+
+int main() {
+  testNothingNew();
+  testHWDataHandoff();
+  return checkExit("seqlock");
+}
@@ -0,0 +1,100 @@
+// ============================================================
+// Parser JSON streaming (telemetry.h): chaves pelo hash perfeito,
+// faixas de FIELDS, valores ignorados e linhas inválidas.
+// ============================================================
+#include <string>
+#include "check.h"
+#include "telemetry.h"
+
+struct Sink {
+  HWData    hw;
+  StageMeta st;
+  HWData    base;  // estado atual: deltas partem dele
+
+  void begin()                          { hw = base; st = StageMeta(); }
+  void number(int field, int64_t v)     { applyNumber(hw, st, field, v); }
+  void string(int field, const char* v) { applyString(hw, st, field, v); }
+};
+
+// Alimenta uma linha (sem '\n'); true se fechou em PS_DONE
+static bool parse(Sink& sink, const std::string& line) {
+  TelemetryParser tp;
+  for (char c : line) parserStep(tp, sink, c);
+  return tp.state == PS_DONE;
+}
+
+static void testKeyTable() {
+  // Toda chave de FIELDS acha o próprio índice; parecidas não casam
+  for (int i = 0; i < FIELD_DEF_COUNT; i++) {
+    CHECK_EQ(lookupKey(keyHashOf(FIELDS[i].name, KEYS.seed), keyLenOf(FIELDS[i].name)), i);
+  }
+  CHECK_EQ(lookupKey(keyHashOf("cpu_", KEYS.seed), 4), -1);
+  CHECK_EQ(lookupKey(keyHashOf("cp", KEYS.seed), 2), -1);
+  CHECK_EQ(lookupKey(keyHashOf("fps", KEYS.seed), 2), -1);
+}
+
+static void testFullMessage() {
+  // Mensagem do monitor.py antigo (json.dumps com espaços)
+  Sink s;
+  CHECK(parse(s, "{\"cpu\": 55, \"gpu\": 100, \"ram\": 40, \"cpu_temp\": 70, \"gpu_temp\": 0, "
+                 "\"fps\": 144, \"cpu_clk\": 4500, \"gpu_clk\": 1800, \"time\": \"12:34\", "
+                 "\"date\": \"16 Oct\"}"));
+  CHECK_EQ(s.hw.cpu, 55);
+  CHECK_EQ(s.hw.gpu, 100);
+  CHECK_EQ(s.hw.fps, 144);
+  CHECK_EQ(s.hw.cpu_clk, 4500);
+  CHECK(!strcmp(s.hw.hora, "12:34"));
+  CHECK(!strcmp(s.hw.data, "16 Oct"));
+  CHECK_EQ(s.st.mask, (1 << FIELD_COUNT) - 1);
+}
+
+static void testDeltaAndMeta() {
+  Sink s;
+  s.base.gpu = 33;
+  CHECK(parse(s, "{\"seq\":7,\"ts\":4000000000,\"kf\":1,\"cpu\":-5,\"fps\":123456}"));
+  CHECK_EQ(s.hw.cpu, 0);      // faixa 0..100
+  CHECK_EQ(s.hw.fps, 9999);   // faixa 0..9999
+  CHECK_EQ(s.hw.gpu, 33);     // ausente no delta: mantém
+  CHECK(s.st.hasSeq && s.st.seq == 7 && s.st.keyframe);
+  CHECK(s.st.hasTs && s.st.ts == 4000000000u);
+  CHECK_EQ(s.st.mask, (1 << FID_CPU) | (1 << FID_FPS));
+}
+
+static void testIgnoredValues() {
+  // Chaves desconhecidas, aninhados, literais e frações não quebram a linha
+  Sink s;
+  CHECK(parse(s, "{\"x\":{\"a\":[1,{\"}\":\"]\"}]},\"ok\":true,\"n\":null,"
+                 "\"cpu\":12.9e1,\"s\":\"a\\\"b\",\"ram\":41}"));
+  CHECK_EQ(s.hw.cpu, 12);  // fração/expoente ignorados
+  CHECK_EQ(s.hw.ram, 41);
+}
+
+static void testCommands() {
+  Sink s;
+  CHECK(parse(s, "{\"cmd\":\"pong\",\"t0\":10,\"t1\":20}"));
+  CHECK(s.st.cmd == CMD_PONG && s.st.t0 == 10 && s.st.t1 == 20);
+  CHECK(parse(s, "{\"cmd\":\"sched\"}"));
+  CHECK(s.st.cmd == CMD_SCHED);
+  CHECK(parse(s, "{\"cmd\":\"reboot\"}"));
+  CHECK(s.st.cmd == CMD_NONE);
+}
+
+static void testInvalid() {
+  Sink s;
+  CHECK(!parse(s, "{\"cpu\":5"));
+  CHECK(!parse(s, "{\"cpu\" 5}"));
+  CHECK(!parse(s, "[1,2]"));
+  CHECK(!parse(s, "{\"cpu\":5}x"));
+  CHECK(!parse(s, "{\"cpu\":@}"));
+  CHECK(parse(s, "  { }  "));
+}
+
+int main() {
+  testKeyTable();
+  testFullMessage();
+  testDeltaAndMeta();
+  testIgnoredValues();
+  testCommands();
+  testInvalid();
+  return checkExit("telemetry");
+}
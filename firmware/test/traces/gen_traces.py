@@ -0,0 +1,71 @@
+"""
+Gera os traces de tempo de frame usados pelo test_frametime.cpp.
+
+Sintéticos, com semente fixa, no formato que o monitor.py manda: um
+tempo por linha em µs, quantizado em 10 µs (u16 no frame 0x03).
+Capturas reais do RTSS no mesmo formato (um valor por linha, '#' para
+comentário) podem ser colocadas aqui: o teste lê todo *.txt.
+
+    python gen_traces.py
+"""
+
+import math
+import os
+import random
+
+FRAMES = 5000
+
+
+def quantize(ms: float) -> int:
+    return max(1, min(65535, round(ms * 100))) * 10
+
+
+def steady_144(rng):
+    # 144 FPS com jitter gaussiano de 0,4 ms
+    return [6.94 + rng.gauss(0, 0.4) for _ in range(FRAMES)]
+
+
+def vsync_60_stutter(rng):
+    # 60 FPS travado, 0,5% de frames que perdem 1-5 vsyncs
+    return [
+        16.67 * rng.randint(2, 6) if rng.random() < 0.005 else 16.67 + rng.gauss(0, 0.1)
+        for _ in range(FRAMES)
+    ]
+
+
+def heavy_tail_300(rng):
+    # ~300 FPS com cauda log-normal (CPU-bound, shader compile)
+    return [3.33 * math.exp(rng.gauss(0, 0.35)) for _ in range(FRAMES)]
+
+
+def scene_change(rng):
+    # Troca de cena no meio (8 → 12 ms) e 0,1% de engasgos de 250 ms
+    out = []
+    for i in range(FRAMES):
+        ms = (8.0 if i < FRAMES // 2 else 12.0) + rng.expovariate(1.0)
+        if rng.random() < 0.001:
+            ms += 250
+        out.append(ms)
+    return out
+
+
+TRACES = {
+    "steady_144.txt": (steady_144, "144 FPS com jitter de 0,4 ms"),
+    "vsync_60_stutter.txt": (vsync_60_stutter, "60 FPS com vsync e vsyncs perdidos"),
+    "heavy_tail_300.txt": (heavy_tail_300, "~300 FPS, cauda log-normal"),
+    "scene_change.txt": (scene_change, "8 -> 12 ms no meio e engasgos de 250 ms"),
+}
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    for seed, (name, (gen, desc)) in enumerate(TRACES.items(), start=1):
+        rng = random.Random(seed)
+        with open(os.path.join(here, name), "w") as f:
+            f.write(f"# {desc} (sintético, gen_traces.py, semente {seed})\n")
+            for ms in gen(rng):
+                f.write(f"{quantize(ms)}\n")
+
+
+if __name__ == "__main__":
+    main()
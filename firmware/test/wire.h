@@ -0,0 +1,57 @@
+// ============================================================
+// Lado do host nos testes: COBS e frames como o monitor.py gera
+// (cobs_encode / encode_frame), para alimentar o LinkRx.
+// ============================================================
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "link_rx.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+static inline Bytes cobsEncode(const Bytes& data) {
+  Bytes out;
+  Bytes block;
+  for (uint8_t b : data) {
+    if (b == 0) {
+      out.push_back((uint8_t)(block.size() + 1));
+      out.insert(out.end(), block.begin(), block.end());
+      block.clear();
+    } else {
+      block.push_back(b);
+      if (block.size() == 254) {
+        out.push_back(0xFF);
+        out.insert(out.end(), block.begin(), block.end());
+        block.clear();
+      }
+    }
+  }
+  out.push_back((uint8_t)(block.size() + 1));
+  out.insert(out.end(), block.begin(), block.end());
+  return out;
+}
+
+static inline Bytes encodeFrame(uint8_t version, uint8_t type, const Bytes& payload) {
+  // 0x00 | COBS(versão, tipo, payload, CRC16 LE) | 0x00
+  Bytes body = { version, type };
+  body.insert(body.end(), payload.begin(), payload.end());
+  uint16_t crc = crc16(body.data(), body.size());
+  body.push_back(crc & 0xFF);
+  body.push_back(crc >> 8);
+
+  Bytes out = { 0x00 };
+  Bytes cobs = cobsEncode(body);
+  out.insert(out.end(), cobs.begin(), cobs.end());
+  out.push_back(0x00);
+  return out;
+}
+
+static inline void append(Bytes& out, const Bytes& b) {
+  out.insert(out.end(), b.begin(), b.end());
+}
+
+static inline void append(Bytes& out, const std::string& s) {
+  out.insert(out.end(), s.begin(), s.end());
+}
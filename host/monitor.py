@@ -9,9 +9,12 @@ import sys
 import os
 import json
 import time
+import struct
+import binascii
 import ctypes
 import ctypes.wintypes
 import logging
+import threading
 
 import psutil
 import serial
@@ -48,7 +51,18 @@ except Exception:
 
 # ── Configuração ─────────────────────────────────────────────
 BAUD_RATE     = 115200
-SEND_INTERVAL = 1.0
+SEND_RATE_HZ  = 10.0    # taxa desejada; limitada pelo max_hz do firmware
+SAMPLE_RATE_HZ = 20.0   # amostragem do histórico; vai em lote nos frames binários
+LEGACY_INTERVAL   = 1.0   # firmware sem handshake: JSON a 1 Hz
+HANDSHAKE_TIMEOUT = 3.0   # espera pelo {"evt":"hello"} do ESP32
+HANDSHAKE_RETRY   = 0.25
+DELTA_MODE     = True   # envia só os campos que mudaram
+KEYFRAME_EVERY = 30     # mensagem completa a cada N envios
+FRAMETIME_POLL = 0.001  # leitura do tempo de frame do RTSS (thread própria)
+EVENT_POLL     = 0.005  # entre envios, lê o ESP32 (e responde pings) neste passo
+STATS_INTERVAL = 60.0   # consulta a saúde do link no ESP32 (0 = nunca)
+PROFILE_STATS  = True   # junto com stats, pede o perfil por estágio do render
+SCHED_STATS    = True   # e o atraso/orçamento de cada tarefa do loop do ESP32
 LOG_LEVEL     = logging.INFO
 
 # ── Logger ───────────────────────────────────────────────────
@@ -66,16 +80,28 @@ log = logging.getLogger("HWMonitor")
 RTSS_SHARED_MEMORY_NAME = "RTSSSharedMemoryV2"
 
 # ── Configurar kernel32 com tipos 64-bit corretos ───────────
-_kernel32 = ctypes.windll.kernel32
-_kernel32.OpenFileMappingW.restype = ctypes.wintypes.HANDLE
-_kernel32.MapViewOfFile.restype = ctypes.c_void_p
-_kernel32.UnmapViewOfFile.argtypes = [ctypes.c_void_p]
-_kernel32.UnmapViewOfFile.restype = ctypes.wintypes.BOOL
-_kernel32.CloseHandle.argtypes = [ctypes.wintypes.HANDLE]
+# Fora do Windows (testes do protocolo) o RTSS só fica indisponível
+_kernel32 = None
+if sys.platform == "win32":
+    _kernel32 = ctypes.windll.kernel32
+    _kernel32.OpenFileMappingW.restype = ctypes.wintypes.HANDLE
+    _kernel32.MapViewOfFile.restype = ctypes.c_void_p
+    _kernel32.UnmapViewOfFile.argtypes = [ctypes.c_void_p]
+    _kernel32.UnmapViewOfFile.restype = ctypes.wintypes.BOOL
+    _kernel32.CloseHandle.argtypes = [ctypes.wintypes.HANDLE]
 
 # Handle para o file mapping do RTSS — manter aberto para performance
 _rtss_handle = None
 _rtss_map_view = None
+# A thread de tempos de frame lê o mesmo mapping; o lock impede que ele
+# seja fechado no meio de uma leitura
+_rtss_lock = threading.RLock()
+
+# Offsets dentro do app entry
+RTSS_APP_TIME0      = 268
+RTSS_APP_TIME1      = 272
+RTSS_APP_FRAMES     = 276
+RTSS_APP_FRAME_TIME = 280   # último tempo de frame, µs
 
 
 def _open_rtss_shared_memory():
@@ -104,6 +130,11 @@ def _open_rtss_shared_memory():
 
 def close_rtss_shared_memory():
     """Fecha o shared memory do RTSS."""
+    with _rtss_lock:
+        _close_rtss_shared_memory()
+
+
+def _close_rtss_shared_memory():
     global _rtss_handle, _rtss_map_view
     if _rtss_map_view:
         _kernel32.UnmapViewOfFile(_rtss_map_view)
@@ -113,47 +144,129 @@ def close_rtss_shared_memory():
         _rtss_handle = None
 
 
-def read_rtss_fps() -> int:
-    """Lê FPS do RTSS shared memory. Retorna 0 se RTSS não estiver rodando."""
+def _rtss_busiest_app() -> tuple[int, int]:
+    """(endereço do app entry, FPS) do app com mais FPS, ou (0, 0).
+
+    Chamar com _rtss_lock.
+    """
     handle, map_view = _open_rtss_shared_memory()
     if not map_view:
-        return 0
+        return 0, 0
 
-    try:
-        mv = map_view
-        sig = ctypes.c_uint32.from_address(mv).value
-        if sig != 0x52545353:
-            return 0
+    mv = map_view
+    sig = ctypes.c_uint32.from_address(mv).value
+    if sig != 0x52545353:
+        return 0, 0
 
-        app_entry_size = ctypes.c_uint32.from_address(mv + 8).value
-        app_arr_offset = ctypes.c_uint32.from_address(mv + 12).value
-        app_arr_size   = ctypes.c_uint32.from_address(mv + 16).value  # num entries
+    app_entry_size = ctypes.c_uint32.from_address(mv + 8).value
+    app_arr_offset = ctypes.c_uint32.from_address(mv + 12).value
+    app_arr_size   = ctypes.c_uint32.from_address(mv + 16).value  # num entries
 
-        if app_arr_size == 0 or app_entry_size == 0:
+    if app_arr_size == 0 or app_entry_size == 0:
+        return 0, 0
+
+    best_base, best_fps = 0, 0
+    for i in range(app_arr_size):
+        base = mv + app_arr_offset + i * app_entry_size
+        pid = ctypes.c_uint32.from_address(base).value
+        if pid == 0:
+            continue
+
+        time0  = ctypes.c_uint32.from_address(base + RTSS_APP_TIME0).value
+        time1  = ctypes.c_uint32.from_address(base + RTSS_APP_TIME1).value
+        frames = ctypes.c_uint32.from_address(base + RTSS_APP_FRAMES).value
+
+        dt = time1 - time0
+        if dt > 0 and frames > 0:
+            fps = int(round(frames * 1000.0 / dt))
+            if fps > best_fps:
+                best_base, best_fps = base, fps
+
+    return best_base, best_fps
+
+
+def read_rtss_fps() -> int:
+    """Lê FPS do RTSS shared memory. Retorna 0 se RTSS não estiver rodando."""
+    with _rtss_lock:
+        try:
+            return _rtss_busiest_app()[1]
+        except Exception:
+            _close_rtss_shared_memory()
             return 0
 
-        best_fps = 0
-        for i in range(app_arr_size):
-            base = mv + app_arr_offset + i * app_entry_size
-            pid = ctypes.c_uint32.from_address(base).value
-            if pid == 0:
-                continue
 
-            # Offsets dentro do app entry: +264=flags, +268=time0, +272=time1, +276=frames
-            time0  = ctypes.c_uint32.from_address(base + 268).value
-            time1  = ctypes.c_uint32.from_address(base + 272).value
-            frames = ctypes.c_uint32.from_address(base + 276).value
+class FrameTimeReader:
+    """Tempo de cada frame (µs) do app com mais FPS no RTSS.
 
-            dt = time1 - time0
-            if dt > 0 and frames > 0:
-                fps = int(round(frames * 1000.0 / dt))
-                if fps > best_fps:
-                    best_fps = fps
+    O RTSS só expõe o tempo do último frame, então uma thread o lê a cada
+    FRAMETIME_POLL e guarda um valor por frame novo (contador de frames
+    mudou) até o próximo drain(). Acima de ~1/FRAMETIME_POLL FPS alguns
+    frames ficam de fora.
+    """
 
-        return best_fps
-    except Exception:
-        close_rtss_shared_memory()
-        return 0
+    REPICK_EVERY = 1.0   # reavalia qual app está na frente
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.times = []
+        self.stopped = threading.Event()
+        thread = threading.Thread(target=self._run, name="rtss-frametime", daemon=True)
+        thread.start()
+
+    def drain(self) -> list:
+        with self.lock:
+            times, self.times = self.times, []
+        return times
+
+    def close(self):
+        self.stopped.set()
+
+    def _run(self):
+        if sys.platform == "win32":
+            ctypes.windll.winmm.timeBeginPeriod(1)  # sleep de 1 ms de verdade
+        try:
+            self._poll()
+        finally:
+            if sys.platform == "win32":
+                ctypes.windll.winmm.timeEndPeriod(1)
+
+    def _poll(self):
+        base, last, repick_at = 0, None, 0.0
+        while not self.stopped.is_set():
+            now = time.monotonic()
+            with _rtss_lock:
+                try:
+                    if now >= repick_at:
+                        base, _ = _rtss_busiest_app()
+                        repick_at = now + self.REPICK_EVERY
+                    if base:
+                        key = (
+                            ctypes.c_uint32.from_address(base + RTSS_APP_TIME0).value,
+                            ctypes.c_uint32.from_address(base + RTSS_APP_FRAMES).value,
+                        )
+                        frame_time = ctypes.c_uint32.from_address(base + RTSS_APP_FRAME_TIME).value
+                        if key != last and last is not None and frame_time:
+                            with self.lock:
+                                self.times.append(frame_time)
+                        last = key
+                except Exception:
+                    _close_rtss_shared_memory()
+                    base, last = 0, None
+            self.stopped.wait(FRAMETIME_POLL if base else self.REPICK_EVERY)
+
+
+def frametime_reader(current, ft_max: int):
+    """FrameTimeReader só roda se o link leva tempos de frame (ft_max > 0).
+
+    A thread faz poll de 1 kHz no RTSS e liga o timer de 1 ms do Windows;
+    com JSON ou firmware sem "ft" isso seria custo sem destino.
+    """
+    if ft_max and current is None:
+        return FrameTimeReader()
+    if not ft_max and current is not None:
+        current.close()
+        return None
+    return current
 
 
 # =============================================================
@@ -278,6 +391,368 @@ def collect_data() -> dict:
     }
 
 
+# =============================================================
+# Protocolo serial — JSON (legado) e frames binários
+# =============================================================
+# Frame: 0x00 | COBS(versão, tipo, seq, ts, máscara, campos LE, CRC16 LE) | 0x00
+PROTO_VERSION  = 3
+FRAME_KEYFRAME = 0x01
+FRAME_DELTA    = 0x02
+FRAME_FRAMETIMES = 0x03   # n | n x tempo de frame (u16, unidades de 10 µs)
+
+# Ordem = bit na máscara do frame; formato struct de cada campo
+TELEMETRY_FIELDS = [
+    ("cpu",      "B"),
+    ("gpu",      "B"),
+    ("ram",      "B"),
+    ("cpu_temp", "B"),
+    ("gpu_temp", "B"),
+    ("fps",      "H"),
+    ("cpu_clk",  "H"),
+    ("gpu_clk",  "H"),
+    ("time",     "BB"),
+    ("date",     "BB"),
+]
+# Métricas com histórico no ESP32: as que podem ir no lote de amostras
+BATCH_FIELDS = TELEMETRY_FIELDS[:6]
+
+
+def crc16_ccitt(data: bytes) -> int:
+    """CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), igual ao firmware."""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def cobs_encode(data: bytes) -> bytes:
+    """Codifica em COBS: a saída não contém nenhum byte 0x00."""
+    out = bytearray()
+    block = bytearray()
+    for b in data:
+        if b == 0:
+            out.append(len(block) + 1)
+            out += block
+            block.clear()
+        else:
+            block.append(b)
+            if len(block) == 254:
+                out.append(0xFF)
+                out += block
+                block.clear()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+def _u8(v: int) -> int:
+    return max(0, min(255, int(v)))
+
+
+def _u16(v: int) -> int:
+    return max(0, min(0xFFFF, int(v)))
+
+
+def host_ms(t: float) -> int:
+    """Instante monotônico em ms (u32), o relógio que o ESP32 sincroniza."""
+    return int(t * 1000) & 0xFFFFFFFF
+
+
+def encode_frame(frame_type: int, payload: bytes) -> bytes:
+    body = struct.pack("<BB", PROTO_VERSION, frame_type) + payload
+    body += struct.pack("<H", crc16_ccitt(body))
+    return b"\x00" + cobs_encode(body) + b"\x00"
+
+
+def _pack_field(name: str, fmt: str, data: dict) -> bytes:
+    value = data[name]
+    if name == "time":
+        try:
+            hour, minute = (int(x) for x in value.split(":"))
+        except ValueError:
+            hour, minute = 0xFF, 0xFF
+        return struct.pack("<BB", hour, minute)
+    if name == "date":
+        try:
+            date = time.strptime(value, "%d %b")
+            return struct.pack("<BB", date.tm_mday, date.tm_mon)
+        except ValueError:
+            return struct.pack("<BB", 0, 0)
+    return struct.pack("<" + fmt, _u8(value) if fmt == "B" else _u16(value))
+
+
+class TelemetryEncoder:
+    """Gera keyframes e deltas numerados (seq 0-255) em JSON ou binário.
+
+    encoding "legacy" (firmware sem handshake): toda mensagem é o JSON
+    completo, sem seq/ts/kf. O parseJson antigo lê chave ausente como 0,
+    então um delta apagaria os campos que não mudaram.
+    """
+
+    def __init__(self, encoding: str, batch_max: int = 0, ft_max: int = 0):
+        self.encoding = encoding
+        self.batch_max = batch_max if encoding == "bin" else 0
+        self.ft_max = ft_max if encoding == "bin" else 0
+        self.seq = 0
+        self.last = None
+        self.since_keyframe = 0
+        self.force_keyframe = True
+
+    def request_keyframe(self):
+        self.force_keyframe = True
+
+    def encode(self, data: dict, sampled_at: float, samples: list | None = None) -> bytes:
+        """sampled_at: instante monotônico da coleta de data.
+        samples: [(instante monotônico, dados)] coletados desde o último envio.
+        """
+        keyframe = (
+            not DELTA_MODE
+            or self.encoding == "legacy"
+            or self.force_keyframe
+            or self.last is None
+            or self.since_keyframe >= KEYFRAME_EVERY
+        )
+        changed = [
+            (name, fmt) for name, fmt in TELEMETRY_FIELDS
+            if keyframe or data[name] != self.last.get(name)
+        ]
+
+        self.seq = (self.seq + 1) & 0xFF
+        if self.encoding == "bin":
+            payload = self._encode_frame(data, changed, keyframe, sampled_at, samples)
+        else:
+            payload = self._encode_json(data, changed, keyframe, sampled_at)
+
+        self.last = dict(data)
+        self.force_keyframe = False
+        self.since_keyframe = 0 if keyframe else self.since_keyframe + 1
+        return payload
+
+    def _encode_frame(self, data: dict, changed: list, keyframe: bool,
+                      sampled_at: float, samples: list | None) -> bytes:
+        mask = 0
+        fields = b""
+        for bit, (name, fmt) in enumerate(TELEMETRY_FIELDS):
+            if (name, fmt) in changed:
+                mask |= 1 << bit
+                fields += _pack_field(name, fmt, data)
+        frame_type = FRAME_KEYFRAME if keyframe else FRAME_DELTA
+        payload = struct.pack("<BIH", self.seq, host_ms(sampled_at), mask) + fields
+        if self.batch_max and samples:
+            payload += self._encode_batch(samples[-self.batch_max:])
+        return encode_frame(frame_type, payload)
+
+    def _encode_batch(self, samples: list) -> bytes:
+        # n | máscara | n x [idade em ms até o envio, valores]
+        now = time.monotonic()
+        batch = struct.pack("<BH", len(samples), (1 << len(BATCH_FIELDS)) - 1)
+        for taken, data in samples:
+            batch += struct.pack("<H", _u16(round((now - taken) * 1000)))
+            for name, fmt in BATCH_FIELDS:
+                batch += _pack_field(name, fmt, data)
+        return batch
+
+    def encode_frametimes(self, times_us: list) -> list:
+        """Frames FRAME_FRAMETIMES com os tempos (µs); vazio se o firmware não aceita."""
+        if not self.ft_max:
+            return []
+        frames = []
+        for i in range(0, len(times_us), self.ft_max):
+            chunk = times_us[i:i + self.ft_max]
+            payload = struct.pack("<B", len(chunk))
+            payload += b"".join(struct.pack("<H", _u16(round(t / 10))) for t in chunk)
+            frames.append(encode_frame(FRAME_FRAMETIMES, payload))
+        return frames
+
+    def _encode_json(self, data: dict, changed: list, keyframe: bool,
+                     sampled_at: float) -> bytes:
+        msg = {}
+        if self.encoding != "legacy":
+            msg = {"seq": self.seq, "ts": host_ms(sampled_at)}
+            if keyframe:
+                msg["kf"] = 1
+        for name, _ in changed:
+            msg[name] = data[name]
+        return (json.dumps(msg, separators=(",", ":")) + "\n").encode("utf-8")
+
+
+# =============================================================
+# Mensagens do firmware (linhas JSON: {"evt": ...})
+# =============================================================
+class DeviceReader:
+    """Lê as linhas que o ESP32 envia sem bloquear o loop de envio."""
+
+    def __init__(self):
+        self.pending = bytearray()
+
+    def reset(self):
+        self.pending.clear()
+
+    def poll(self, ser) -> list:
+        events = []
+        waiting = ser.in_waiting
+        if not waiting:
+            return events
+        self.pending += ser.read(waiting)
+
+        while b"\n" in self.pending:
+            line, _, rest = self.pending.partition(b"\n")
+            self.pending = bytearray(rest)
+            line = line.strip()
+            if not line.startswith(b"{"):
+                continue
+            try:
+                events.append(json.loads(line))
+            except ValueError:
+                log.debug(f"Linha inválida do ESP32: {line!r}")
+        return events
+
+
+def log_link_stats(stats: dict):
+    log.info(
+        "Link: %s B/s, %s msg/s, dt %s ms | erros json=%s frame=%s crc=%s "
+        "overflow=%s | seq gaps=%s drops=%s keyframes=%s",
+        stats.get("bps"), stats.get("mps"), stats.get("gap_ms"),
+        stats.get("json_err"), stats.get("frame_err"), stats.get("crc_err"),
+        stats.get("overflow"), stats.get("seq_gaps"), stats.get("delta_drops"),
+        stats.get("kf_req"),
+    )
+    if stats.get("clk_sync"):
+        parse, push = stats.get("lat_parse", [0] * 3), stats.get("lat_push", [0] * 3)
+        log.info(
+            "Latência p50/p95/p99: parse %s/%s/%s ms, tela %s/%s/%s ms "
+            "(rtt %s ms, drift %s ppm)",
+            *parse, *push, stats.get("clk_rtt"), stats.get("drift_ppm"),
+        )
+    if stats.get("wx_age_s", -1) >= 0 or stats.get("wx_fail"):
+        log.info(
+            "Clima: idade %s s, %s falha(s) seguida(s), último status %s",
+            stats.get("wx_age_s"), stats.get("wx_fail"), stats.get("wx_status"),
+        )
+    if "net_heap" in stats:
+        # net_heap é a queda da heap global durante a busca (outras tasks
+        # entram junto); net_body é a resposta que o parse guardou na heap
+        loc, wx = stats["net_heap"]
+        body_loc, body_wx = stats.get("net_body", ("?", "?"))
+        log.info(
+            "Heap: livre %s B (mínimo %s B); queda durante a busca (global): "
+            "local %s B, clima %s B; corpo na heap: local %s B, clima %s B",
+            stats.get("heap_free"), stats.get("heap_min"), loc, wx, body_loc, body_wx,
+        )
+    if "push_us" in stats:
+        log.info(
+            "Display: render %s us, push %s us, fence %s us (%s)",
+            stats.get("render_us"), stats["push_us"], stats.get("fence_us"),
+            "assíncrono" if stats.get("async_push") else "síncrono",
+        )
+
+
+def log_profile(prof: dict):
+    # {"evt":"prof","unit":"us","n":64,"frame":[min,avg,p99],...}
+    stages = [
+        f"{name} {v[0]}/{v[1]}/{v[2]}"
+        for name, v in prof.items()
+        if isinstance(v, list) and len(v) == 3
+    ]
+    log.info("Perfil min/avg/p99 (%s): %s", prof.get("unit", "us"), ", ".join(stages))
+
+
+def log_schedule(sched: dict):
+    # {"evt":"sched","render":{"runs":N,"late":[p50,p95,p99],"max_us":N,...},...}
+    tasks = [
+        f"{name} {t['late'][0]}/{t['late'][2]} ms max {t.get('max_us')} us"
+        + (f" ({t['over']} acima de {t.get('budget_us')} us)" if t.get("over") else "")
+        for name, t in sched.items()
+        if isinstance(t, dict) and isinstance(t.get("late"), list) and len(t["late"]) == 3
+    ]
+    log.info("Agendador atraso p50/p99: %s", ", ".join(tasks))
+
+
+def send_pong(ser, ping: dict):
+    """Responde o ping de sincronia com o nosso relógio (ver host_ms)."""
+    pong = {"cmd": "pong", "t0": ping.get("t0", 0), "t1": host_ms(time.monotonic())}
+    ser.write((json.dumps(pong, separators=(",", ":")) + "\n").encode("utf-8"))
+
+
+def wait_serving(ser, reader, deadline: float, pending: list):
+    """Dorme até deadline lendo o ESP32 a cada EVENT_POLL.
+
+    Pings são respondidos na hora: o pong atrasado até o próximo envio
+    somaria até um intervalo ao RTT e enviesaria o offset do relógio.
+    Os demais eventos vão para pending e o loop os trata após o envio.
+    """
+    while True:
+        try:
+            for evt in reader.poll(ser):
+                if evt.get("evt") == "ping":
+                    send_pong(ser, evt)
+                else:
+                    pending.append(evt)
+        except serial.SerialException:
+            # O próximo envio do loop detecta a queda e reconecta
+            time.sleep(max(0.0, deadline - time.monotonic()))
+            return
+        delay = deadline - time.monotonic()
+        if delay <= 0:
+            return
+        time.sleep(min(delay, EVENT_POLL))
+
+
+# =============================================================
+# Handshake — negocia codificação e taxa com o firmware
+# =============================================================
+def choose_link(hello: dict) -> tuple[str, float, int, int]:
+    """Escolhe a codificação mais rápida e a maior taxa que os dois lados suportam.
+
+    Retorna (codificação, intervalo de envio, máximo de amostras por lote,
+    máximo de tempos de frame por frame; 0 = não envia).
+    """
+    encoding = "json"
+    if "bin" in hello.get("enc", []) and hello.get("proto") == PROTO_VERSION:
+        encoding = "bin"
+
+    # max_hz 0 (ou ausente) não pode virar divisão por zero
+    rate = min(SEND_RATE_HZ, max(1.0, float(hello.get("max_hz", 1))))
+    # Lote só compensa se amostramos mais rápido do que enviamos
+    batch = int(hello.get("batch", 0)) if encoding == "bin" and SAMPLE_RATE_HZ > rate else 0
+    ft_max = int(hello.get("ft", 0)) if encoding == "bin" else 0
+    log.info(
+        "Firmware: protocolo %s, até %s Hz, %d campos → %s a %.0f Hz%s%s",
+        hello.get("proto"), hello.get("max_hz"), len(hello.get("fields", [])),
+        encoding, rate,
+        f", amostras a {SAMPLE_RATE_HZ:.0f} Hz em lote" if batch else "",
+        ", tempos de frame" if ft_max else "",
+    )
+    return encoding, 1.0 / rate, batch, ft_max
+
+
+def handshake(ser, reader) -> tuple[str, float, int, int]:
+    """Pergunta as capacidades ao ESP32; sem resposta assume firmware antigo."""
+    deadline = time.monotonic() + HANDSHAKE_TIMEOUT
+    next_hello = 0.0
+    while time.monotonic() < deadline:
+        if time.monotonic() >= next_hello:
+            ser.write(b'{"cmd":"hello"}\n')
+            next_hello = time.monotonic() + HANDSHAKE_RETRY
+
+        for evt in reader.poll(ser):
+            if evt.get("evt") == "hello":
+                return choose_link(evt)
+        time.sleep(0.02)
+
+    log.warning("ESP32 não respondeu ao handshake; usando JSON completo a %.0f Hz.",
+                1.0 / LEGACY_INTERVAL)
+    return "legacy", LEGACY_INTERVAL, 0, 0
+
+
+def open_serial(port: str):
+    ser = serial.Serial()
+    ser.port = port
+    ser.baudrate = BAUD_RATE
+    ser.timeout = 1
+    ser.dtr = False
+    ser.rts = False
+    ser.open()
+    return ser
+
+
 # =============================================================
 # Baixa prioridade
 # =============================================================
@@ -318,33 +793,75 @@ def main():
 
     # Abre conexão serial
     try:
-        ser = serial.Serial()
-        ser.port = port
-        ser.baudrate = BAUD_RATE
-        ser.timeout = 1
-        ser.dtr = False
-        ser.rts = False
-        ser.open()
+        ser = open_serial(port)
         log.info(f"Conectado em {port} @ {BAUD_RATE} baud")
     except serial.SerialException as e:
         log.error(f"Erro ao abrir {port}: {e}")
         sys.exit(1)
 
-    # Aguarda ESP32 inicializar
-    time.sleep(2)
+    reader = DeviceReader()
+    encoding, interval, batch, ft_max = handshake(ser, reader)
+    encoder = TelemetryEncoder(encoding, batch, ft_max)
+    frametimes = frametime_reader(None, ft_max)
+    samples = []
+    events = []   # lidos enquanto esperava o envio (wait_serving)
+    last_stats_query = time.monotonic()
+    next_send = next_sample = time.monotonic()
 
     log.info("Enviando dados... (Ctrl+C para parar)")
     log.info("FPS via RTSS: %s", "disponível" if read_rtss_fps() >= 0 else "não detectado")
 
     try:
         while True:
-            data = collect_data()
-            payload = json.dumps(data) + "\n"
+            if batch and time.monotonic() >= next_sample:
+                samples.append((time.monotonic(), collect_data()))
+                next_sample = max(next_sample + 1.0 / SAMPLE_RATE_HZ, time.monotonic())
+                if time.monotonic() < next_send:
+                    wait_serving(ser, reader, min(next_sample, next_send), events)
+                    continue
+
+            if samples:
+                sampled_at, data = samples[-1]
+            else:
+                sampled_at, data = time.monotonic(), collect_data()
+            payload = encoder.encode(data, sampled_at, samples)
+            samples = []
 
             try:
-                ser.write(payload.encode("utf-8"))
+                ser.write(payload)
                 log.debug(f"Enviado: {data}")
+                for frame in encoder.encode_frametimes(frametimes.drain() if frametimes else []):
+                    ser.write(frame)
+
+                if STATS_INTERVAL and time.monotonic() - last_stats_query >= STATS_INTERVAL:
+                    last_stats_query = time.monotonic()
+                    ser.write(b'{"cmd":"stats"}\n')
+                    if PROFILE_STATS:
+                        ser.write(b'{"cmd":"prof"}\n')
+                    if SCHED_STATS:
+                        ser.write(b'{"cmd":"sched"}\n')
+
+                events += reader.poll(ser)
+                for evt in events:
+                    if evt.get("evt") == "ping":
+                        send_pong(ser, evt)
+                    elif evt.get("evt") == "keyframe":
+                        log.debug("ESP32 pediu keyframe.")
+                        encoder.request_keyframe()
+                    elif evt.get("evt") == "stats":
+                        log_link_stats(evt)
+                    elif evt.get("evt") == "prof":
+                        log_profile(evt)
+                    elif evt.get("evt") == "sched":
+                        log_schedule(evt)
+                    elif evt.get("evt") == "hello":
+                        # ESP32 reiniciou (ou estava bootando no handshake)
+                        encoding, interval, batch, ft_max = choose_link(evt)
+                        encoder = TelemetryEncoder(encoding, batch, ft_max)
+                        frametimes = frametime_reader(frametimes, ft_max)
+                events = []
             except serial.SerialException:
+                events = []
                 log.warning("Conexão perdida. Reconectando...")
                 ser.close()
                 time.sleep(2)
@@ -352,25 +869,28 @@ def main():
                 port = find_esp32_port()
                 if port:
                     try:
-                        ser = serial.Serial()
-                        ser.port = port
-                        ser.baudrate = BAUD_RATE
-                        ser.timeout = 1
-                        ser.dtr = False
-                        ser.rts = False
-                        ser.open()
+                        ser = open_serial(port)
                         log.info(f"Reconectado em {port}")
-                        time.sleep(1)
+                        reader.reset()
+                        encoding, interval, batch, ft_max = handshake(ser, reader)
+                        encoder = TelemetryEncoder(encoding, batch, ft_max)
+                        frametimes = frametime_reader(frametimes, ft_max)
                     except serial.SerialException:
                         log.error("Falha na reconexão.")
                 else:
                     log.error("ESP32 não encontrado para reconexão.")
 
-            time.sleep(SEND_INTERVAL)
+            # Agenda pelo relógio monotônico: o tempo de coleta não atrasa a taxa
+            next_send += interval
+            if next_send < time.monotonic():
+                next_send = time.monotonic()
+            wake = min(next_send, next_sample) if batch else next_send
+            wait_serving(ser, reader, wake, events)
 
     except KeyboardInterrupt:
         log.info("Encerrado pelo usuário.")
     finally:
+        frametime_reader(frametimes, 0)
         close_rtss_shared_memory()
         if lhm_computer:
             lhm_computer.Close()
@@ -0,0 +1,145 @@
+"""
+Servidor local no lugar do ip-api/open-meteo, para testar a task de rede
+do firmware (build "net-test", -DNET_TEST_HOST=...) com respostas lentas
+ou perdidas. Cada pedido recebe o próximo comportamento da sequência:
+
+    ok      responde na hora
+    slow    responde depois de --delay s (abaixo do timeout de 5 s do ESP32)
+    hang    aceita e não responde (o ESP32 desiste no timeout)
+    drop    fecha a conexão sem resposta
+    bad     200 com JSON truncado (erro de parse no ESP32)
+
+Uso:
+    python net_standin.py --port 8080 --pattern ok,slow,hang,drop
+"""
+
+import argparse
+import itertools
+import json
+import logging
+import socket
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+BEHAVIORS = ("ok", "slow", "hang", "drop", "bad")
+HANG_LIMIT = 60.0   # "hang" segura a conexão no máximo isso
+
+log = logging.getLogger("NetStandIn")
+
+
+def location_body() -> dict:
+    # Mesmo formato do ip-api com ?fields=lat,lon
+    return {"lat": -23.5505, "lon": -46.6333}
+
+
+def weather_body(query: dict) -> dict:
+    # Recorte do open-meteo com &current=temperature_2m,weather_code
+    lat = float(query.get("latitude", ["0"])[0])
+    lon = float(query.get("longitude", ["0"])[0])
+    return {
+        "latitude": lat,
+        "longitude": lon,
+        "generationtime_ms": 0.05,
+        "utc_offset_seconds": 0,
+        "timezone": "GMT",
+        "current_units": {"time": "iso8601", "interval": "seconds",
+                          "temperature_2m": "°C", "weather_code": "wmo code"},
+        "current": {"time": time.strftime("%Y-%m-%dT%H:%M", time.gmtime()),
+                    "interval": 900, "temperature_2m": 24.3, "weather_code": 3},
+    }
+
+
+class StandInServer(ThreadingHTTPServer):
+    daemon_threads = True
+
+    def __init__(self, addr, pattern, delay):
+        super().__init__(addr, StandInHandler)
+        self.pattern = itertools.cycle(pattern)
+        self.delay = delay
+        self.lock = threading.Lock()
+        self.closing = threading.Event()
+        self.served = []   # (caminho, comportamento) de cada pedido
+
+    def next_behavior(self, path: str) -> str:
+        with self.lock:
+            behavior = next(self.pattern)
+            self.served.append((path, behavior))
+        return behavior
+
+    def server_close(self):
+        self.closing.set()   # solta os "hang"
+        super().server_close()
+
+
+class StandInHandler(BaseHTTPRequestHandler):
+    server: StandInServer
+
+    def do_GET(self):
+        url = urlparse(self.path)
+        if url.path.startswith("/json"):
+            body = location_body()
+        elif url.path == "/v1/forecast":
+            body = weather_body(parse_qs(url.query))
+        else:
+            self.send_error(404)
+            return
+
+        behavior = self.server.next_behavior(url.path)
+        log.info("%s %s -> %s", self.client_address[0], url.path, behavior)
+        if behavior == "drop":
+            self.connection.shutdown(socket.SHUT_RDWR)
+            self.close_connection = True
+            return
+        if behavior == "hang":
+            self.server.closing.wait(HANG_LIMIT)
+            self.close_connection = True
+            return
+        if behavior == "slow":
+            time.sleep(self.server.delay)
+
+        data = json.dumps(body).encode()
+        if behavior == "bad":
+            data = data[:len(data) // 2]
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def log_message(self, fmt, *args):
+        pass   # o do_GET já loga cada pedido
+
+
+def parse_pattern(text: str) -> list:
+    pattern = [p.strip() for p in text.split(",") if p.strip()]
+    unknown = [p for p in pattern if p not in BEHAVIORS]
+    if not pattern or unknown:
+        raise argparse.ArgumentTypeError(
+            f"use {', '.join(BEHAVIORS)} separados por vírgula")
+    return pattern
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("--bind", default="0.0.0.0")
+    ap.add_argument("--port", type=int, default=8080)
+    ap.add_argument("--pattern", type=parse_pattern, default=["ok", "slow", "hang", "drop"])
+    ap.add_argument("--delay", type=float, default=4.0, help="atraso do 'slow' (s)")
+    args = ap.parse_args()
+
+    logging.basicConfig(level=logging.INFO,
+                        format="[%(asctime)s] %(message)s", datefmt="%H:%M:%S")
+    server = StandInServer((args.bind, args.port), args.pattern, args.delay)
+    log.info("ouvindo em %s:%d, sequência %s", args.bind, args.port, ",".join(args.pattern))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.server_close()
+
+
+if __name__ == "__main__":
+    main()
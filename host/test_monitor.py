@@ -0,0 +1,262 @@
+"""
+Testes do protocolo serial do monitor.py (roda em qualquer SO):
+
+    cd host
+    python -m unittest -v
+"""
+
+import importlib
+import json
+import struct
+import sys
+import threading
+import time
+import types
+import unittest
+from unittest import mock
+
+# psutil/pyserial só são usados pelo loop real; sem eles os testes
+# do protocolo ainda rodam
+for _name in ("psutil", "serial", "serial.tools", "serial.tools.list_ports"):
+    try:
+        importlib.import_module(_name)
+    except ImportError:
+        sys.modules[_name] = types.ModuleType(_name)
+if not hasattr(sys.modules["serial"], "SerialException"):
+    sys.modules["serial"].SerialException = type("SerialException", (OSError,), {})
+
+import monitor  # noqa: E402
+
+monitor.log.disabled = True  # handshake/choose_link logam a cada caso
+
+
+def cobs_decode(data: bytes) -> bytes:
+    """Inverso de cobs_encode (mesmo algoritmo do cobsDecode do firmware)."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        block = data[i + 1:i + code]
+        if code == 0 or len(block) != code - 1:
+            raise ValueError("COBS corrompido")
+        out += block
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class FakeSerial:
+    """in_waiting/read/write do pyserial sobre um buffer em memória."""
+
+    def __init__(self, chunks=()):
+        self.chunks = list(chunks)
+        self.written = bytearray()
+
+    @property
+    def in_waiting(self):
+        return len(self.chunks[0]) if self.chunks else 0
+
+    def read(self, n):
+        return self.chunks.pop(0)[:n]
+
+    def write(self, data):
+        self.written += data
+
+
+class TimedSerial(FakeSerial):
+    """Bytes que só ficam disponíveis a partir de um instante (monotônico)."""
+
+    def __init__(self, arrivals):
+        super().__init__()
+        self.arrivals = list(arrivals)   # [(instante, bytes)]
+        self.writes = []                 # [(instante, bytes)]
+
+    @property
+    def in_waiting(self):
+        if self.arrivals and time.monotonic() >= self.arrivals[0][0]:
+            return len(self.arrivals[0][1])
+        return 0
+
+    def read(self, n):
+        return self.arrivals.pop(0)[1][:n]
+
+    def write(self, data):
+        self.writes.append((time.monotonic(), bytes(data)))
+
+
+class FramingTest(unittest.TestCase):
+    def test_crc_reference_vector(self):
+        self.assertEqual(monitor.crc16_ccitt(b"123456789"), 0x29B1)
+
+    def test_cobs_has_no_zero_and_round_trips(self):
+        cases = [
+            b"",
+            b"\x00",
+            b"\x00\x00\x00",
+            bytes(range(1, 255)),              # bloco cheio: código 0xFF
+            bytes(range(1, 255)) + b"\x00\x01",
+            bytes(i % 7 for i in range(600)),
+        ]
+        for data in cases:
+            encoded = monitor.cobs_encode(data)
+            self.assertNotIn(0, encoded)
+            self.assertEqual(cobs_decode(encoded), data)
+
+    def test_frame_matches_firmware_reference(self):
+        # Mesmo vetor de firmware/test/test_link_rx.cpp (testFrameFromHost)
+        payload = struct.pack("<BIH", 1, 1000, 0x21) + bytes([55, 0x90, 0x01])
+        frame = monitor.encode_frame(monitor.FRAME_KEYFRAME, payload)
+        self.assertEqual(frame.hex(), "0006030101e803010221063790016d7a00")
+
+    def test_batch_matches_firmware_reference(self):
+        # Mesmo vetor de firmware/test/test_sample_batch.cpp (REF_BATCH)
+        samples = [
+            (9.90, dict(cpu=5, gpu=250, ram=3, cpu_temp=45, gpu_temp=60, fps=1440)),
+            (9.95, dict(cpu=7, gpu=8, ram=9, cpu_temp=200, gpu_temp=61, fps=300)),
+        ]
+        with mock.patch.object(monitor.time, "monotonic", return_value=10.0):
+            batch = monitor.TelemetryEncoder("bin", 24)._encode_batch(samples)
+        self.assertEqual(batch.hex(), "023f00" "640005fa032d3ca005" "3200070809c83d2c01")
+
+    def test_batch_is_the_rest_of_the_payload(self):
+        # n x (idade + valores) fecha exatamente o frame: o firmware
+        # recusa o lote inteiro se sobrar ou faltar byte
+        data = dict(cpu=1, gpu=2, ram=3, cpu_temp=4, gpu_temp=5, fps=6,
+                    cpu_clk=7, gpu_clk=8, time="12:34", date="01 Jan")
+        samples = [(time.monotonic(), data)] * 30
+        frame = monitor.TelemetryEncoder("bin", 24).encode(data, time.monotonic(), samples)
+        body = cobs_decode(frame[1:-1])
+        payload = body[2:-2]
+        fields = sum(struct.calcsize("<" + fmt) for _, fmt in monitor.TELEMETRY_FIELDS)
+        batch = payload[7 + fields:]
+        n, mask = struct.unpack("<BH", batch[:3])
+        record = 2 + sum(struct.calcsize("<" + fmt) for _, fmt in monitor.BATCH_FIELDS)
+        self.assertEqual(n, 24)
+        self.assertEqual(mask, 0x3F)
+        self.assertEqual(len(batch), 3 + n * record)
+
+    def test_frame_layout(self):
+        frame = monitor.encode_frame(monitor.FRAME_DELTA, b"\x00\x01\x02")
+        self.assertEqual(frame[0], 0)
+        self.assertEqual(frame[-1], 0)
+        self.assertNotIn(0, frame[1:-1])
+        body = cobs_decode(frame[1:-1])
+        self.assertEqual(body[:2], bytes([monitor.PROTO_VERSION, monitor.FRAME_DELTA]))
+        self.assertEqual(body[2:-2], b"\x00\x01\x02")
+        self.assertEqual(struct.unpack("<H", body[-2:])[0], monitor.crc16_ccitt(body[:-2]))
+
+
+class DeviceReaderTest(unittest.TestCase):
+    def test_lines_split_across_reads(self):
+        ser = FakeSerial([b'{"evt":"hel', b'lo","proto":3}\n{"evt":', b'"ping","t0":5}\n'])
+        reader = monitor.DeviceReader()
+        events = []
+        for _ in range(3):
+            events += reader.poll(ser)
+        self.assertEqual(events, [{"evt": "hello", "proto": 3}, {"evt": "ping", "t0": 5}])
+
+    def test_ignores_log_and_broken_lines(self):
+        ser = FakeSerial([b'boot log\r\n{"evt":\n  {"evt":"stats"}\r\n'])
+        self.assertEqual(monitor.DeviceReader().poll(ser), [{"evt": "stats"}])
+
+    def test_no_data(self):
+        self.assertEqual(monitor.DeviceReader().poll(FakeSerial()), [])
+
+
+SAMPLE = {
+    "cpu": 12, "gpu": 40, "ram": 55, "cpu_temp": 61, "gpu_temp": 58,
+    "fps": 144, "cpu_clk": 4650, "gpu_clk": 1905, "time": "12:34", "date": "16 Oct",
+}
+
+
+class HandshakeTest(unittest.TestCase):
+    def test_no_hello_falls_back_to_full_json(self):
+        ser = FakeSerial()
+        with mock.patch.object(monitor, "HANDSHAKE_TIMEOUT", 0.05):
+            link = monitor.handshake(ser, monitor.DeviceReader())
+        self.assertEqual(link, ("legacy", monitor.LEGACY_INTERVAL, 0, 0))
+        self.assertIn(b'{"cmd":"hello"}\n', bytes(ser.written))
+
+    def test_legacy_encoder_always_sends_every_field(self):
+        # Firmware antigo lê chave ausente como 0: nada de delta, seq ou ts
+        enc = monitor.TelemetryEncoder("legacy")
+        for cpu in (12, 12, 13):
+            msg = json.loads(enc.encode(dict(SAMPLE, cpu=cpu), 0.0))
+            self.assertEqual(msg, dict(SAMPLE, cpu=cpu))
+
+    def test_json_encoder_sends_deltas(self):
+        enc = monitor.TelemetryEncoder("json")
+        first = json.loads(enc.encode(SAMPLE, 1.0))
+        second = json.loads(enc.encode(dict(SAMPLE, cpu=13), 1.1))
+        self.assertEqual(first["kf"], 1)
+        self.assertEqual(set(second), {"seq", "ts", "cpu"})
+        self.assertEqual(second["seq"], (first["seq"] + 1) & 0xFF)
+
+    def test_zero_max_hz_is_clamped(self):
+        for hello in ({"max_hz": 0}, {"max_hz": -5}, {}):
+            _, interval, _, _ = monitor.choose_link(dict(hello, proto=3, enc=["json"]))
+            self.assertLessEqual(interval, 1.0)
+            self.assertGreater(interval, 0)
+
+    def test_binary_link(self):
+        hello = {"proto": monitor.PROTO_VERSION, "enc": ["json", "bin"],
+                 "max_hz": 60, "batch": 24, "ft": 96}
+        encoding, interval, batch, ft_max = monitor.choose_link(hello)
+        self.assertEqual(encoding, "bin")
+        self.assertAlmostEqual(interval, 1.0 / monitor.SEND_RATE_HZ)
+        self.assertEqual(ft_max, 96)
+
+
+class FrameTimeReaderTest(unittest.TestCase):
+    @staticmethod
+    def rtss_threads():
+        return [t for t in threading.enumerate() if t.name == "rtss-frametime"]
+
+    def test_not_started_without_ft(self):
+        # JSON ou firmware sem "ft": nada de poll de 1 kHz no RTSS
+        self.assertIsNone(monitor.frametime_reader(None, 0))
+        self.assertEqual(self.rtss_threads(), [])
+
+    def test_started_and_stopped_with_link(self):
+        reader = monitor.frametime_reader(None, 96)
+        self.assertIsInstance(reader, monitor.FrameTimeReader)
+        self.assertIs(monitor.frametime_reader(reader, 96), reader)
+        self.assertIsNone(monitor.frametime_reader(reader, 0))
+        for t in self.rtss_threads():
+            t.join(timeout=2)
+        self.assertEqual(self.rtss_threads(), [])
+
+
+class WaitServingTest(unittest.TestCase):
+    def test_ping_answered_while_waiting(self):
+        # Ping no meio da espera: pong sai em ~EVENT_POLL, não no próximo envio
+        start = time.monotonic()
+        ser = TimedSerial([
+            (start + 0.02, b'{"evt":"ping","t0":77}\n'),
+            (start + 0.03, b'{"evt":"keyframe"}\n'),
+        ])
+        pending = []
+        monitor.wait_serving(ser, monitor.DeviceReader(), start + 0.2, pending)
+
+        self.assertGreaterEqual(time.monotonic(), start + 0.2)
+        self.assertEqual(len(ser.writes), 1)
+        sent_at, pong = ser.writes[0]
+        self.assertEqual(json.loads(pong)["cmd"], "pong")
+        self.assertEqual(json.loads(pong)["t0"], 77)
+        self.assertLess(sent_at - (start + 0.02), 0.05)
+        self.assertEqual(pending, [{"evt": "keyframe"}])
+
+    def test_serial_error_just_waits(self):
+        class Broken(FakeSerial):
+            @property
+            def in_waiting(self):
+                raise monitor.serial.SerialException("caiu")
+
+        start = time.monotonic()
+        monitor.wait_serving(Broken(), monitor.DeviceReader(), start + 0.05, [])
+        self.assertGreaterEqual(time.monotonic(), start + 0.05)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,100 @@
+"""
+Testes do servidor de teste da rede (net_standin.py):
+
+    cd host
+    python -m unittest -v
+"""
+
+import http.client
+import json
+import threading
+import time
+import unittest
+
+import net_standin
+
+net_standin.log.disabled = True
+
+
+class StandInTest(unittest.TestCase):
+    def start(self, pattern, delay=0.3):
+        server = net_standin.StandInServer(("127.0.0.1", 0), pattern, delay)
+        thread = threading.Thread(target=server.serve_forever, daemon=True)
+        thread.start()
+
+        def stop():
+            server.shutdown()
+            server.server_close()
+            thread.join(2)
+        self.addCleanup(stop)
+        return server
+
+    def get(self, server, path, timeout=2.0):
+        conn = http.client.HTTPConnection("127.0.0.1", server.server_address[1], timeout=timeout)
+        self.addCleanup(conn.close)
+        conn.request("GET", path)
+        resp = conn.getresponse()
+        return resp.status, resp.read()
+
+    def test_location_and_weather_have_the_fields_the_firmware_filters(self):
+        server = self.start(["ok"])
+        status, body = self.get(server, "/json/?fields=lat,lon")
+        self.assertEqual(status, 200)
+        loc = json.loads(body)
+        self.assertIn("lat", loc)
+        self.assertIn("lon", loc)
+
+        status, body = self.get(server, "/v1/forecast?latitude=-23.5505&longitude=-46.6333"
+                                        "&current=temperature_2m,weather_code")
+        self.assertEqual(status, 200)
+        wx = json.loads(body)
+        self.assertEqual(wx["latitude"], -23.5505)
+        self.assertIsInstance(wx["current"]["temperature_2m"], float)
+        self.assertIsInstance(wx["current"]["weather_code"], int)
+
+    def test_pattern_cycles_per_request(self):
+        server = self.start(["ok", "slow"], delay=0.3)
+        t0 = time.monotonic()
+        self.get(server, "/json/")
+        fast = time.monotonic() - t0
+        t0 = time.monotonic()
+        status, _ = self.get(server, "/json/")
+        slow = time.monotonic() - t0
+        self.assertEqual(status, 200)
+        self.assertLess(fast, 0.25)
+        self.assertGreaterEqual(slow, 0.3)
+        self.assertEqual([b for _, b in server.served], ["ok", "slow"])
+
+    def test_drop_closes_without_response(self):
+        server = self.start(["drop"])
+        with self.assertRaises((http.client.RemoteDisconnected, ConnectionError)):
+            self.get(server, "/v1/forecast?latitude=0&longitude=0")
+
+    def test_hang_runs_into_client_timeout(self):
+        server = self.start(["hang"])
+        t0 = time.monotonic()
+        with self.assertRaises(TimeoutError):
+            self.get(server, "/json/", timeout=0.3)
+        self.assertGreaterEqual(time.monotonic() - t0, 0.3)
+
+    def test_bad_is_truncated_json(self):
+        server = self.start(["bad"])
+        status, body = self.get(server, "/json/")
+        self.assertEqual(status, 200)
+        with self.assertRaises(ValueError):
+            json.loads(body)
+
+    def test_unknown_path_is_404_and_not_counted(self):
+        server = self.start(["drop"])
+        status, _ = self.get(server, "/favicon.ico")
+        self.assertEqual(status, 404)
+        self.assertEqual(server.served, [])
+
+    def test_parse_pattern(self):
+        self.assertEqual(net_standin.parse_pattern("ok, hang"), ["ok", "hang"])
+        with self.assertRaises(Exception):
+            net_standin.parse_pattern("ok,lento")
+
+
+if __name__ == "__main__":
+    unittest.main()